@@ -27,15 +27,38 @@ void LifetimeImpl::terminate()
 		actions_copy = std::move(actions);
 
 		actions.clear();
+		removed_actions = 0;
 	}
 	// endregion
 
 	for (auto it = actions_copy.rbegin(); it != actions_copy.rend(); ++it)
 	{
-		it->second();
+		if (it->second)
+		{
+			it->second();
+		}
 	}
 }
 
+void LifetimeImpl::compact_actions()
+{
+	actions_t alive;
+	// reserve(0) leaves tsl::ordered_map without buckets, the next insert crashes
+	if (actions.size() > removed_actions)
+	{
+		alive.reserve(actions.size() - removed_actions);
+	}
+	for (auto it = actions.begin(); it != actions.end(); ++it)
+	{
+		if (it->second)
+		{
+			alive.emplace(it->first, std::move(it.value()));
+		}
+	}
+	actions = std::move(alive);
+	removed_actions = 0;
+}
+
 bool LifetimeImpl::is_terminated() const
 {
 	return terminated;
@@ -53,7 +76,7 @@ void LifetimeImpl::attach_nested(std::shared_ptr<LifetimeImpl> nested)
 
 	std::function<void()> action = [nested] { nested->terminate(); };
 	counter_t action_id = add_action(action);
-	nested->add_action([this, id = action_id] { actions.erase(id); });
+	nested->add_action([this, id = action_id] { remove_action(id); });
 }
 
 LifetimeImpl::~LifetimeImpl()
@@ -39,9 +39,13 @@ private:
 	counter_t action_id_in_map = 0;
 	using actions_t = ordered_map<int, std::function<void()>, rd::hash<int>>;
 	actions_t actions;
+	// number of removed actions still kept in [actions] as empty functions
+	size_t removed_actions = 0;
 
 	void terminate();
 
+	void compact_actions();
+
 	std::mutex actions_lock;
 
 public:
@@ -75,7 +79,18 @@ public:
 	{
 		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
 
-		actions.erase(i);
+		// erasing from the middle of an ordered map shifts the rest of it, so leave an empty action
+		// and drop them all at once when they make up half of the map
+		auto it = actions.find(i);
+		if (it == actions.end() || !it->second)
+		{
+			return;
+		}
+		it.value() = nullptr;
+		if (++removed_actions > actions.size() / 2)
+		{
+			compact_actions();
+		}
 	}
 
 #if __cplusplus >= 201703L
@@ -6,6 +6,8 @@
 
 #include <util/core_util.h>
 
+#include <memory>
+
 namespace rd
 {
 /**
@@ -17,6 +19,22 @@ class Property : public IProperty<T>
 {
 	using WT = typename IProperty<T>::WT;
 
+	// last value handed out by snapshot(), maintained once enable_snapshots is called
+	mutable std::shared_ptr<T const> published;
+
+	mutable bool publish = false;
+
+	static std::shared_ptr<T const> share(Wrapper<T> const& value)
+	{
+		// values held in wrappers are replaced, never modified, so they are shared as is
+		return value;
+	}
+
+	static std::shared_ptr<T const> share(optional<T> const& value)
+	{
+		return value ? std::make_shared<T const>(*value) : nullptr;
+	}
+
 public:
 	// region ctor/dtor
 
@@ -49,10 +67,36 @@ public:
 				this->before_change.fire(*(this->value));
 			}
 			this->value = std::move(new_value);
+			if (publish)
+			{
+				std::atomic_store(&published, share(this->value));
+			}
 			this->change.fire(*(this->value));
 		}
 	}
 
+	/**
+	 * \brief Start publishing immutable snapshots of the value on every change, see \ref snapshot.
+	 * \details Values stored in wrappers are shared with the snapshot, other values are copied once per change.
+	 */
+	void enable_snapshots() const
+	{
+		if (!publish)
+		{
+			publish = true;
+			std::atomic_store(&published, this->has_value() ? share(this->value) : nullptr);
+		}
+	}
+
+	/**
+	 * \brief Safe to call from any thread once \ref enable_snapshots was called on the owner thread.
+	 * \return the value as of the last change, or nullptr if there is none. It stays unchanged while it is held.
+	 */
+	std::shared_ptr<T const> snapshot() const
+	{
+		return std::atomic_load(&published);
+	}
+
 	friend bool operator==(const Property& lhs, const Property& rhs)
 	{
 		return &lhs == &rhs;
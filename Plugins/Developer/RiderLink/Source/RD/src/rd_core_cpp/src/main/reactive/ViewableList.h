@@ -4,9 +4,11 @@
 #include "base/IViewableList.h"
 #include "reactive/base/SignalX.h"
 #include "util/core_util.h"
+#include "std/hash.h"
 
 #include <algorithm>
 #include <iterator>
+#include <unordered_set>
 #include <utility>
 
 namespace rd
@@ -35,6 +37,82 @@ protected:
 		return list;
 	}
 
+	template <typename It>
+	static std::vector<T const*> pointers(It first, It last)
+	{
+		std::vector<T const*> res;
+		res.reserve(std::distance(first, last));
+		std::transform(first, last, std::back_inserter(res), [](Wrapper<T> const& ptr) { return &(*ptr); });
+		return res;
+	}
+
+	/**
+	 * \brief Removes elements for which [matches] holds, firing a range event per run of adjacent ones.
+	 */
+	template <typename P>
+	bool remove_matching(P&& matches) const
+	{
+		// single compaction pass; removed elements stay alive in [removed] until their events are fired
+		data_t removed;
+		std::vector<std::pair<size_t, size_t>> runs;	// [index in the original list, first position in removed]
+		auto dst = list.begin();
+		for (auto src = list.begin(); src != list.end(); ++src)
+		{
+			if (matches(**src))
+			{
+				const size_t index = std::distance(list.begin(), src);
+				if (runs.empty() || runs.back().first + (removed.size() - runs.back().second) != index)
+				{
+					runs.emplace_back(index, removed.size());
+				}
+				removed.push_back(std::move(*src));
+			}
+			else
+			{
+				if (dst != src)
+				{
+					*dst = std::move(*src);
+				}
+				++dst;
+			}
+		}
+		if (runs.empty())
+		{
+			return false;
+		}
+		list.erase(dst, list.end());
+
+		// fire back to front so that the indices of the runs before stay valid
+		size_t end = removed.size();
+		for (auto it = runs.rbegin(); it != runs.rend(); ++it)
+		{
+			const auto first = removed.begin() + it->second;
+			change.fire(typename Event::RemoveRange(static_cast<int32_t>(it->first), pointers(first, removed.begin() + end)));
+			end = it->second;
+		}
+		return true;
+	}
+
+	bool remove_all_of(std::vector<WT> const& elements, std::true_type /*hashable*/) const
+	{
+		std::unordered_set<T const*, wrapper::TransparentHash<T>, wrapper::TransparentKeyEqual<T>> keys;
+		keys.reserve(elements.size());
+		for (auto const& element : elements)
+		{
+			keys.insert(&wrapper::get<T>(element));
+		}
+		return remove_matching([&keys](T const& x) { return keys.count(&x) > 0; });
+	}
+
+	bool remove_all_of(std::vector<WT> const& elements, std::false_type /*hashable*/) const
+	{
+		// no hash to index the arguments by, each element is compared to all of them
+		return remove_matching([&elements](T const& x) {
+			return std::any_of(elements.begin(), elements.end(),
+				[&x](auto const& element) { return wrapper::get<T>(element) == x; });
+		});
+	}
+
 public:
 	// region ctor/dtor
 
@@ -209,9 +287,9 @@ public:
 		if (lifetime->is_terminated())
 			return;
 		change.advise(lifetime, handler);
-		for (int32_t i = 0; i < static_cast<int32_t>(size()); ++i)
+		if (!list.empty())
 		{
-			handler(typename Event::Add(i, &(*list[i])));
+			handler(typename Event::AddRange(0, pointers(list.begin(), list.end())));
 		}
 	}
 
@@ -264,54 +342,52 @@ public:
 
 	bool addAll(size_t index, std::vector<WT> elements) const override
 	{
+		if (elements.empty())
+		{
+			return true;
+		}
+		data_t wrapped;
+		wrapped.reserve(elements.size());
 		for (auto& element : elements)
 		{
-			ViewableList::add(index, std::move(element));
-			++index;
+			wrapped.emplace_back(std::move(element));
 		}
+		const auto first =
+			list.insert(list.begin() + index, std::make_move_iterator(wrapped.begin()), std::make_move_iterator(wrapped.end()));
+		change.fire(typename Event::AddRange(static_cast<int32_t>(index), pointers(first, first + wrapped.size())));
 		return true;
 	}
 
 	bool addAll(std::vector<WT> elements) const override
 	{
-		for (auto&& element : elements)
-		{
-			ViewableList::add(std::move(element));
-		}
-		return true;
+		return ViewableList::addAll(size(), std::move(elements));
 	}
 
 	void clear() const override
 	{
-		std::vector<Event> changes;
-		for (size_t i = size(); i > 0; --i)
-		{
-			changes.push_back(typename Event::Remove(static_cast<int32_t>(i - 1), &(*list[i - 1])));
-		}
-		for (auto const& e : changes)
+		if (list.empty())
 		{
-			change.fire(e);
+			return;
 		}
-		list.clear();
+		data_t old_list;
+		std::swap(old_list, list);
+		change.fire(typename Event::Reset(pointers(old_list.begin(), old_list.end())));
 	}
 
 	bool removeAll(std::vector<WT> elements) const override
 	{
-		// TO-DO faster
-		//        std::unordered_set<T> set(elements.begin(), elements.end());
+		return remove_all_of(elements, util::is_hashable<T>{});
+	}
 
-		bool res = false;
-		for (size_t i = list.size(); i > 0; --i)
+	void removeRange(size_t index, size_t count) const override
+	{
+		if (count == 0)
 		{
-			auto const& x = list[i - 1];
-			if (std::count_if(elements.begin(), elements.end(),
-					[&x](auto const& elem) { return wrapper::TransparentKeyEqual<T>()(elem, x); }) > 0)
-			{
-				removeAt(i - 1);
-				res = true;
-			}
+			return;
 		}
-		return res;
+		data_t removed(std::make_move_iterator(list.begin() + index), std::make_move_iterator(list.begin() + index + count));
+		list.erase(list.begin() + index, list.begin() + index + count);
+		change.fire(typename Event::RemoveRange(static_cast<int32_t>(index), pointers(removed.begin(), removed.end())));
 	}
 
 	size_t size() const override
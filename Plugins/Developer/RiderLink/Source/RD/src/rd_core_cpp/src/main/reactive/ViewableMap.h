@@ -6,6 +6,7 @@
 
 #include <util/core_util.h>
 #include <std/unordered_map.h>
+#include <std/flat_ordered_map.h>
 
 #include <thirdparty.hpp>
 
@@ -16,8 +17,10 @@ namespace rd
 {
 /**
  * \brief complete class which has @code IViewableMap<K, V>'s properties
+ * \tparam Storage WrapperStorage or InlineStorage
  */
-template <typename K, typename V, typename KA = std::allocator<K>, typename VA = std::allocator<V>>
+template <typename K, typename V, typename KA = std::allocator<K>, typename VA = std::allocator<V>,
+	typename Storage = WrapperStorage>
 class ViewableMap : public IViewableMap<K, V>
 {
 public:
@@ -328,6 +331,243 @@ public:
 		return map.empty();
 	}
 };
+
+/**
+ * \brief ViewableMap keeping small trivially copyable keys and values inline, see InlineStorage.
+ */
+template <typename K, typename V, typename KA, typename VA>
+class ViewableMap<K, V, KA, VA, InlineStorage> : public IViewableMap<K, V>
+{
+	static_assert(util::is_inline_storable_v<K> && util::is_inline_storable_v<V>,
+		"InlineStorage requires small trivially copyable keys and values");
+
+public:
+	using Event = typename IViewableMap<K, V>::Event;
+
+private:
+	using WK = typename IViewableMap<K, V>::WK;
+	using WV = typename IViewableMap<K, V>::WV;
+	using OV = typename IViewableMap<K, V>::OV;
+
+	Signal<Event> change;
+
+	using data_t = flat_ordered_map<K, V>;
+	mutable data_t map;
+
+public:
+	// region ctor/dtor
+
+	ViewableMap() = default;
+
+	ViewableMap(ViewableMap&&) = default;
+
+	ViewableMap& operator=(ViewableMap&&) = default;
+
+	virtual ~ViewableMap() = default;
+	// endregion
+
+	// region iterators
+
+public:
+	class iterator
+	{
+		friend class ViewableMap;
+
+		typename data_t::iterator it_;
+
+		explicit iterator(const typename data_t::iterator& it) : it_(it)
+		{
+		}
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using key_type = K;
+		using value_type = V;
+		using difference_type = std::ptrdiff_t;
+		using reference = V const&;
+		using pointer = V const*;
+
+		iterator& operator++()
+		{
+			++it_;
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		iterator& operator--()
+		{
+			--it_;
+			return *this;
+		}
+
+		iterator operator--(int)
+		{
+			auto it = *this;
+			--*this;
+			return it;
+		}
+
+		bool operator==(iterator const& other) const noexcept
+		{
+			return this->it_ == other.it_;
+		}
+
+		bool operator!=(iterator const& other) const noexcept
+		{
+			return !(*this == other);
+		}
+
+		reference operator*() const noexcept
+		{
+			return it_->second;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &it_->second;
+		}
+
+		key_type const& key() const
+		{
+			return it_->first;
+		}
+
+		value_type const& value() const
+		{
+			return it_->second;
+		}
+	};
+
+	class reverse_iterator : public std::reverse_iterator<iterator>
+	{
+		using base_t = std::reverse_iterator<iterator>;
+
+	public:
+		using key_type = typename iterator::key_type;
+		using value_type = typename iterator::value_type;
+
+		explicit reverse_iterator(const iterator& other) : base_t(other){};
+
+		key_type const& key() const
+		{
+			auto it = base_t::current;
+			return (--(it)).key();
+		}
+
+		value_type const& value() const
+		{
+			auto it = base_t::current;
+			return (--it).value();
+		}
+	};
+
+	iterator begin() const
+	{
+		return iterator(map.begin());
+	}
+
+	iterator end() const
+	{
+		return iterator(map.end());
+	}
+
+	reverse_iterator rbegin() const
+	{
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend() const
+	{
+		return reverse_iterator(begin());
+	}
+
+	// endregion
+
+	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override
+	{
+		change.advise(lifetime, handler);
+		for (auto const& entry : map)
+		{
+			handler(Event(typename Event::Add(&entry.first, &entry.second)));
+		}
+	}
+
+	const V* get(K const& key) const override
+	{
+		auto entry = map.find(key);
+		return entry ? &entry->second : nullptr;
+	}
+
+	const V* set(WK key, WV value) const override
+	{
+		auto inserted = map.insert({key, value});
+		auto entry = inserted.first;
+		if (inserted.second)
+		{
+			change.fire(typename Event::Add(&entry->first, &entry->second));
+			return nullptr;
+		}
+		if (entry->second != value)
+		{
+			const V old_value = entry->second;
+			entry->second = value;
+			change.fire(typename Event::Update(&entry->first, &old_value, &entry->second));
+		}
+		return &entry->second;
+	}
+
+	OV remove(K const& key) const override
+	{
+		auto entry = map.find(key);
+		if (!entry)
+		{
+			return nullopt;
+		}
+		const V old_value = entry->second;
+		change.fire(typename Event::Remove(&entry->first, &old_value));
+		map.erase(key);
+		return old_value;
+	}
+
+	void clear() const override
+	{
+		std::vector<Event> changes;
+		changes.reserve(map.size());
+		for (auto const& entry : map)
+		{
+			changes.push_back(typename Event::Remove(&entry.first, &entry.second));
+		}
+		for (auto const& e : changes)
+		{
+			change.fire(e);
+		}
+		map.clear();
+	}
+
+	size_t size() const override
+	{
+		return map.size();
+	}
+
+	bool empty() const override
+	{
+		return map.empty();
+	}
+
+	/**
+	 * \return approximate number of bytes taken by the elements
+	 */
+	size_t memory_usage() const
+	{
+		return map.memory_usage();
+	}
+};
 }	 // namespace rd
 
 static_assert(std::is_move_constructible<rd::ViewableMap<int, int>>::value, "Is move constructible from ViewableMap<int, int>");
@@ -5,6 +5,7 @@
 #include "reactive/base/SignalX.h"
 
 #include <std/allocator.h>
+#include <std/flat_ordered_map.h>
 #include <util/core_util.h>
 
 namespace rd
@@ -12,8 +13,9 @@ namespace rd
 /**
  * \brief complete class which has @code IViewableSet<T>'s properties
  * \tparam T
+ * \tparam Storage WrapperStorage or InlineStorage
  */
-template <typename T, typename A = allocator<T>>
+template <typename T, typename A = allocator<T>, typename Storage = WrapperStorage>
 class ViewableSet : public IViewableSet<T, A>
 {
 public:
@@ -265,6 +267,153 @@ public:
 		return add(WT{std::forward<Args>(args)...});
 	}
 };
+
+/**
+ * \brief ViewableSet keeping small trivially copyable elements inline, see InlineStorage.
+ */
+template <typename T, typename A>
+class ViewableSet<T, A, InlineStorage> : public IViewableSet<T, A>
+{
+	static_assert(util::is_inline_storable_v<T>, "InlineStorage requires small trivially copyable elements");
+
+public:
+	using Event = typename IViewableSet<T>::Event;
+
+	using IViewableSet<T, A>::advise;
+
+private:
+	using WT = typename IViewableSet<T, A>::WT;
+
+	Signal<Event> change;
+	using data_t = flat_ordered_set<T>;
+	mutable data_t set;
+
+public:
+	// region ctor/dtor
+
+	ViewableSet() = default;
+
+	ViewableSet(ViewableSet&&) = default;
+
+	ViewableSet& operator=(ViewableSet&&) = default;
+
+	virtual ~ViewableSet() = default;
+	// endregion
+
+	// region iterators
+public:
+	using iterator = typename data_t::iterator;
+
+	using reverse_iterator = std::reverse_iterator<iterator>;
+
+	iterator begin() const
+	{
+		return set.begin();
+	}
+
+	iterator end() const
+	{
+		return set.end();
+	}
+
+	reverse_iterator rbegin() const
+	{
+		return reverse_iterator(end());
+	}
+
+	reverse_iterator rend() const
+	{
+		return reverse_iterator(begin());
+	}
+
+	// endregion
+
+	bool add(WT element) const override
+	{
+		auto const& it = set.insert(element);
+		if (!it.second)
+		{
+			return false;
+		}
+		change.fire(Event(AddRemove::ADD, it.first));
+		return true;
+	}
+
+	bool addAll(std::vector<WT> elements) const override
+	{
+		set.reserve(set.size() + elements.size());
+		for (auto const& element : elements)
+		{
+			ViewableSet::add(element);
+		}
+		return true;
+	}
+
+	void clear() const override
+	{
+		std::vector<Event> changes;
+		changes.reserve(set.size());
+		for (auto const& element : set)
+		{
+			changes.push_back(Event(AddRemove::REMOVE, &element));
+		}
+		for (auto const& e : changes)
+		{
+			change.fire(e);
+		}
+		set.clear();
+	}
+
+	bool remove(T const& element) const override
+	{
+		T const* it = set.find(element);
+		if (!it)
+		{
+			return false;
+		}
+		change.fire(Event(AddRemove::REMOVE, it));
+		set.erase(element);
+		return true;
+	}
+
+	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override
+	{
+		for (auto const& x : set)
+		{
+			handler(Event(AddRemove::ADD, &x));
+		}
+		change.advise(lifetime, handler);
+	}
+
+	size_t size() const override
+	{
+		return set.size();
+	}
+
+	bool contains(T const& element) const override
+	{
+		return set.find(element) != nullptr;
+	}
+
+	bool empty() const override
+	{
+		return set.empty();
+	}
+
+	template <typename... Args>
+	bool emplace_add(Args&&... args) const
+	{
+		return add(WT{std::forward<Args>(args)...});
+	}
+
+	/**
+	 * \return approximate number of bytes taken by the elements
+	 */
+	size_t memory_usage() const
+	{
+		return set.memory_usage();
+	}
+};
 }	 // namespace rd
 
 static_assert(std::is_move_constructible<rd::ViewableSet<int>>::value, "Is move constructible from ViewableSet<int>");
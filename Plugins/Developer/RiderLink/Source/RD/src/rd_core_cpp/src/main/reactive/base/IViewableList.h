@@ -13,6 +13,7 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <iterator>
 
 #include "thirdparty.hpp"
 
@@ -58,7 +59,48 @@ public:
 		}
 	};
 
-	variant<Add, Update, Remove> v;
+	/**
+	 * \brief [new_values] were inserted starting at [index], in order.
+	 */
+	class AddRange
+	{
+	public:
+		int32_t index;
+		std::vector<T const*> new_values;
+
+		AddRange(int32_t index, std::vector<T const*> new_values) : index(index), new_values(std::move(new_values))
+		{
+		}
+	};
+
+	/**
+	 * \brief [old_values] were removed starting at [index], in order.
+	 */
+	class RemoveRange
+	{
+	public:
+		int32_t index;
+		std::vector<T const*> old_values;
+
+		RemoveRange(int32_t index, std::vector<T const*> old_values) : index(index), old_values(std::move(old_values))
+		{
+		}
+	};
+
+	/**
+	 * \brief The list was cleared, [old_values] are its former contents.
+	 */
+	class Reset
+	{
+	public:
+		std::vector<T const*> old_values;
+
+		explicit Reset(std::vector<T const*> old_values) : old_values(std::move(old_values))
+		{
+		}
+	};
+
+	variant<Add, Update, Remove, AddRange, RemoveRange, Reset> v;
 
 	ListEvent(Add x) : v(x)
 	{
@@ -72,17 +114,41 @@ public:
 	{
 	}
 
+	ListEvent(AddRange x) : v(std::move(x))
+	{
+	}
+
+	ListEvent(RemoveRange x) : v(std::move(x))
+	{
+	}
+
+	ListEvent(Reset x) : v(std::move(x))
+	{
+	}
+
 	int32_t get_index() const
 	{
 		return visit(util::make_visitor([](Add const& e) { return e.index; }, [](Update const& e) { return e.index; },
-						 [](Remove const& e) { return e.index; }),
+						 [](Remove const& e) { return e.index; }, [](AddRange const& e) { return e.index; },
+						 [](RemoveRange const& e) { return e.index; }, [](Reset const& /*e*/) { return 0; }),
 			v);
 	}
 
 	T const* get_new_value() const
 	{
 		return visit(util::make_visitor([](Add const& e) { return e.new_value; }, [](Update const& e) { return e.new_value; },
-						 [](Remove const& /*e*/) { return static_cast<T const*>(nullptr); }),
+						 [](auto const& /*e*/) { return static_cast<T const*>(nullptr); }),
+			v);
+	}
+
+	/**
+	 * \return number of elements affected by this event
+	 */
+	size_t get_count() const
+	{
+		return visit(util::make_visitor([](AddRange const& e) { return e.new_values.size(); },
+						 [](RemoveRange const& e) { return e.old_values.size(); }, [](Reset const& e) { return e.old_values.size(); },
+						 [](auto const& /*e*/) { return static_cast<size_t>(1); }),
 			v);
 	}
 
@@ -96,7 +162,14 @@ public:
 						   //                       to_string(e.old_value) + ":" +
 						   to_string(*e.new_value);
 				},
-				[](typename ListEvent::Remove const& e) { return "Remove " + std::to_string(e.index); }),
+				[](typename ListEvent::Remove const& e) { return "Remove " + std::to_string(e.index); },
+				[](typename ListEvent::AddRange const& e) {
+					return "AddRange " + std::to_string(e.index) + ":" + std::to_string(e.new_values.size());
+				},
+				[](typename ListEvent::RemoveRange const& e) {
+					return "RemoveRange " + std::to_string(e.index) + ":" + std::to_string(e.old_values.size());
+				},
+				[](typename ListEvent::Reset const& e) { return "Reset " + std::to_string(e.old_values.size()); }),
 			e.v);
 		return res;
 	}
@@ -114,7 +187,7 @@ protected:
 
 public:
 	/**
-	 * \brief Represents an addition, update or removal of an element in the list.
+	 * \brief Represents an addition, update or removal of an element or a contiguous range of elements in the list.
 	 */
 	using Event = typename detail::ListEvent<T>;
 
@@ -136,18 +209,33 @@ public:
 	/**
 	 * \brief Adds a subscription to additions and removals of list elements. When a list element is updated,
 	 * the [handler] is called twice: to report the removal of the old element and the addition of the new one.
+	 * Range events are reported element by element: additions front to back, removals back to front.
 	 * \param lifetime lifetime of subscription.
 	 * \param handler to be called.
 	 */
 	void advise_add_remove(Lifetime lifetime, std::function<void(AddRemove, size_t, T const&)> handler) const
 	{
-		advise(lifetime, [handler](Event e) {
-			visit(util::make_visitor([handler](typename Event::Add const& e) { handler(AddRemove::ADD, e.index, *e.new_value); },
-					  [handler](typename Event::Update const& e) {
+		advise(lifetime, [handler](Event const& e) {
+			const auto remove_range = [&handler](size_t index, std::vector<T const*> const& old_values) {
+				for (size_t i = old_values.size(); i > 0; --i)
+				{
+					handler(AddRemove::REMOVE, index + i - 1, *old_values[i - 1]);
+				}
+			};
+			visit(util::make_visitor([&handler](typename Event::Add const& e) { handler(AddRemove::ADD, e.index, *e.new_value); },
+					  [&handler](typename Event::Update const& e) {
 						  handler(AddRemove::REMOVE, e.index, *e.old_value);
 						  handler(AddRemove::ADD, e.index, *e.new_value);
 					  },
-					  [handler](typename Event::Remove const& e) { handler(AddRemove::REMOVE, e.index, *e.old_value); }),
+					  [&handler](typename Event::Remove const& e) { handler(AddRemove::REMOVE, e.index, *e.old_value); },
+					  [&handler](typename Event::AddRange const& e) {
+						  for (size_t i = 0; i < e.new_values.size(); ++i)
+						  {
+							  handler(AddRemove::ADD, e.index + i, *e.new_values[i]);
+						  }
+					  },
+					  [&remove_range](typename Event::RemoveRange const& e) { remove_range(e.index, e.old_values); },
+					  [&remove_range](typename Event::Reset const& e) { remove_range(0, e.old_values); }),
 				e.v);
 		});
 	}
@@ -167,26 +255,17 @@ public:
 	 */
 	void view(Lifetime lifetime, std::function<void(Lifetime, size_t, T const&)> handler) const
 	{
-		advise_add_remove(lifetime, [this, lifetime, handler](AddRemove kind, size_t idx, T const& value) {
-			switch (kind)
-			{
-				case AddRemove::ADD:
-				{
-					LifetimeDefinition def(lifetime);
-					std::vector<LifetimeDefinition>& v = lifetimes[lifetime];
-					auto it = v.emplace(v.begin() + idx, std::move(def));
-					handler(it->lifetime, idx, value);
-					break;
-				}
-				case AddRemove::REMOVE:
-				{
-					LifetimeDefinition def = std::move(lifetimes.at(lifetime)[idx]);
-					std::vector<LifetimeDefinition>& v = lifetimes.at(lifetime);
-					v.erase(v.begin() + idx);
-					def.terminate();
-					break;
-				}
-			}
+		advise(lifetime, [this, lifetime, handler](Event const& e) {
+			visit(util::make_visitor([&](typename Event::Add const& e) { view_add(lifetime, handler, e.index, {e.new_value}); },
+					  [&](typename Event::Update const& e) {
+						  view_remove(lifetime, e.index, 1);
+						  view_add(lifetime, handler, e.index, {e.new_value});
+					  },
+					  [&](typename Event::Remove const& e) { view_remove(lifetime, e.index, 1); },
+					  [&](typename Event::AddRange const& e) { view_add(lifetime, handler, e.index, e.new_values); },
+					  [&](typename Event::RemoveRange const& e) { view_remove(lifetime, e.index, e.old_values.size()); },
+					  [&](typename Event::Reset const& e) { view_remove(lifetime, 0, e.old_values.size()); }),
+				e.v);
 		});
 	}
 
@@ -212,6 +291,11 @@ public:
 
 	virtual bool removeAll(std::vector<WT> elements) const = 0;
 
+	/**
+	 * \brief Removes [count] elements starting at [index] with a single \ref Event::RemoveRange.
+	 */
+	virtual void removeRange(size_t index, size_t count) const = 0;
+
 	virtual size_t size() const = 0;
 
 	virtual bool empty() const = 0;
@@ -240,6 +324,39 @@ public:
 
 protected:
 	virtual const std::vector<Wrapper<T>>& getList() const = 0;
+
+private:
+	void view_add(Lifetime const& lifetime, std::function<void(Lifetime, size_t, T const&)> const& handler, size_t index,
+		std::vector<T const*> const& values) const
+	{
+		std::vector<LifetimeDefinition> defs;
+		defs.reserve(values.size());
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			defs.emplace_back(lifetime);
+		}
+		std::vector<Lifetime> nested;
+		nested.reserve(values.size());
+		std::transform(defs.begin(), defs.end(), std::back_inserter(nested), [](LifetimeDefinition const& def) { return def.lifetime; });
+
+		std::vector<LifetimeDefinition>& v = lifetimes[lifetime];
+		v.insert(v.begin() + index, std::make_move_iterator(defs.begin()), std::make_move_iterator(defs.end()));
+		for (size_t i = 0; i < values.size(); ++i)
+		{
+			handler(nested[i], index + i, *values[i]);
+		}
+	}
+
+	void view_remove(Lifetime const& lifetime, size_t index, size_t count) const
+	{
+		std::vector<LifetimeDefinition>& v = lifetimes.at(lifetime);
+		std::vector<LifetimeDefinition> defs(std::make_move_iterator(v.begin() + index), std::make_move_iterator(v.begin() + index + count));
+		v.erase(v.begin() + index, v.begin() + index + count);
+		for (size_t i = defs.size(); i > 0; --i)
+		{
+			defs[i - 1].terminate();
+		}
+	}
 };
 
 template <typename T>
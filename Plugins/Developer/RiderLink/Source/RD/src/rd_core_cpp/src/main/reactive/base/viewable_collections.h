@@ -5,6 +5,23 @@
 
 namespace rd
 {
+/**
+ * \brief Default storage policy of ViewableMap and ViewableSet: every key and value lives in its own Wrapper inside
+ * an ordered hash map. Works for any type, pointers to elements stay valid until the element is removed.
+ */
+struct WrapperStorage
+{
+};
+
+/**
+ * \brief Storage policy of ViewableMap and ViewableSet keeping keys and values inline in a flat open-addressing
+ * table (see flat_ordered_map). Requires util::is_inline_storable types. Iteration order, events and validity of
+ * element pointers are the same as with WrapperStorage, iterators are bidirectional only.
+ */
+struct InlineStorage
+{
+};
+
 enum class AddRemove
 {
 	ADD,
@@ -29,7 +46,11 @@ enum class Op
 	ADD,
 	UPDATE,
 	REMOVE,
-	ACK
+	ACK,
+	ADD_RANGE,
+	REMOVE_RANGE,
+	BATCH,
+	ACK_RANGE
 };
 
 inline std::string to_string(Op op)
@@ -44,6 +65,14 @@ inline std::string to_string(Op op)
 			return "Remove";
 		case Op::ACK:
 			return "Ack";
+		case Op::ADD_RANGE:
+			return "AddRange";
+		case Op::REMOVE_RANGE:
+			return "RemoveRange";
+		case Op::BATCH:
+			return "Batch";
+		case Op::ACK_RANGE:
+			return "AckRange";
 		default:
 			return "";
 	}
@@ -0,0 +1,407 @@
+#ifndef RD_CPP_FLAT_ORDERED_MAP_H
+#define RD_CPP_FLAT_ORDERED_MAP_H
+
+#include "hash.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rd
+{
+namespace detail
+{
+/**
+ * \brief Key/value pair of flat_ordered_map; unlike std::pair it is trivially copyable for trivially copyable K and V.
+ */
+template <typename K, typename V>
+struct flat_entry
+{
+	K first;
+	V second;
+};
+
+struct select_self
+{
+	template <typename T>
+	T const& operator()(T const& value) const noexcept
+	{
+		return value;
+	}
+};
+
+struct select_first
+{
+	template <typename K, typename V>
+	K const& operator()(flat_entry<K, V> const& value) const noexcept
+	{
+		return value.first;
+	}
+};
+
+/**
+ * \brief Insertion-ordered hash table for small trivially copyable elements.
+ *
+ * \details Elements are stored inline in slots which are never moved while the element is alive, so pointers to them
+ * stay valid until the element is erased. Slots are chained in insertion order and reused after erasure.
+ * Lookup goes through a flat open-addressing index (linear probing, backward shift deletion) holding slot numbers
+ * and hash bits only.
+ *
+ * \tparam T type of stored elements
+ * \tparam Key type of lookup keys
+ * \tparam KeyOf functor extracting key from element
+ */
+template <typename T, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+class flat_ordered_table
+{
+	static_assert(std::is_trivially_copyable<T>::value, "flat_ordered_table stores trivially copyable elements only");
+
+	using index_t = uint32_t;
+
+	static constexpr index_t npos = (std::numeric_limits<index_t>::max)();
+
+	static constexpr size_t min_buckets = 8;
+
+	struct slot
+	{
+		T value;
+		// neighbours in insertion order; [next] links the free list while the slot is unused
+		index_t prev;
+		index_t next;
+	};
+
+	struct bucket
+	{
+		index_t slot = npos;
+		// upper bits of the mixed hash, the ideal bucket is derived from them
+		uint32_t hash = 0;
+	};
+
+	std::deque<slot> slots;
+	std::vector<bucket> buckets;
+	index_t head = npos;
+	index_t tail = npos;
+	index_t free_head = npos;
+	size_t count = 0;
+	uint32_t bucket_bits = 0;
+
+	Hash hasher;
+	KeyEqual key_equal;
+	KeyOf key_of;
+
+	static uint32_t mix(size_t h) noexcept
+	{
+		return static_cast<uint32_t>((static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+
+	size_t ideal_bucket(uint32_t hash) const noexcept
+	{
+		return hash >> (32 - bucket_bits);
+	}
+
+	size_t mask() const noexcept
+	{
+		return buckets.size() - 1;
+	}
+
+	size_t find_bucket(Key const& key, uint32_t hash) const
+	{
+		if (buckets.empty())
+		{
+			return npos;
+		}
+		for (size_t i = ideal_bucket(hash);; i = (i + 1) & mask())
+		{
+			bucket const& b = buckets[i];
+			if (b.slot == npos)
+			{
+				return npos;
+			}
+			if (b.hash == hash && key_equal(key_of(slots[b.slot].value), key))
+			{
+				return i;
+			}
+		}
+	}
+
+	void place(index_t slot_index, uint32_t hash)
+	{
+		size_t i = ideal_bucket(hash);
+		while (buckets[i].slot != npos)
+		{
+			i = (i + 1) & mask();
+		}
+		buckets[i].slot = slot_index;
+		buckets[i].hash = hash;
+	}
+
+	void rehash(size_t bucket_count)
+	{
+		std::vector<bucket> old = std::move(buckets);
+		buckets.assign(bucket_count, bucket{});
+		bucket_bits = 0;
+		while ((size_t(1) << bucket_bits) < bucket_count)
+		{
+			++bucket_bits;
+		}
+		for (bucket const& b : old)
+		{
+			if (b.slot != npos)
+			{
+				place(b.slot, b.hash);
+			}
+		}
+	}
+
+	index_t allocate_slot(T const& value)
+	{
+		index_t index;
+		if (free_head != npos)
+		{
+			index = free_head;
+			free_head = slots[index].next;
+			slots[index].value = value;
+		}
+		else
+		{
+			index = static_cast<index_t>(slots.size());
+			slots.push_back(slot{value, npos, npos});
+		}
+		slot& s = slots[index];
+		s.prev = tail;
+		s.next = npos;
+		if (tail != npos)
+		{
+			slots[tail].next = index;
+		}
+		else
+		{
+			head = index;
+		}
+		tail = index;
+		return index;
+	}
+
+	void release_slot(index_t index)
+	{
+		slot& s = slots[index];
+		(s.prev != npos ? slots[s.prev].next : head) = s.next;
+		(s.next != npos ? slots[s.next].prev : tail) = s.prev;
+		s.prev = npos;
+		s.next = free_head;
+		free_head = index;
+	}
+
+	void erase_bucket(size_t i)
+	{
+		// backward shift: pull following entries of the probe sequence into the hole
+		size_t hole = i;
+		for (size_t j = (i + 1) & mask();; j = (j + 1) & mask())
+		{
+			bucket const& b = buckets[j];
+			if (b.slot == npos)
+			{
+				break;
+			}
+			const size_t ideal = ideal_bucket(b.hash);
+			if (((j - ideal) & mask()) >= ((j - hole) & mask()))
+			{
+				buckets[hole] = b;
+				hole = j;
+			}
+		}
+		buckets[hole] = bucket{};
+	}
+
+public:
+	class iterator
+	{
+		friend class flat_ordered_table;
+
+		flat_ordered_table const* table = nullptr;
+		index_t index = npos;
+
+		iterator(flat_ordered_table const* table, index_t index) : table(table), index(index)
+		{
+		}
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T const*;
+		using reference = T const&;
+
+		iterator() = default;
+
+		iterator& operator++()
+		{
+			index = table->slots[index].next;
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			auto it = *this;
+			++*this;
+			return it;
+		}
+
+		iterator& operator--()
+		{
+			index = index == npos ? table->tail : table->slots[index].prev;
+			return *this;
+		}
+
+		iterator operator--(int)
+		{
+			auto it = *this;
+			--*this;
+			return it;
+		}
+
+		reference operator*() const noexcept
+		{
+			return table->slots[index].value;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &table->slots[index].value;
+		}
+
+		bool operator==(iterator const& other) const noexcept
+		{
+			return index == other.index;
+		}
+
+		bool operator!=(iterator const& other) const noexcept
+		{
+			return !(*this == other);
+		}
+	};
+
+	using const_iterator = iterator;
+
+	iterator begin() const
+	{
+		return iterator(this, head);
+	}
+
+	iterator end() const
+	{
+		return iterator(this, npos);
+	}
+
+	size_t size() const noexcept
+	{
+		return count;
+	}
+
+	bool empty() const noexcept
+	{
+		return count == 0;
+	}
+
+	void reserve(size_t n)
+	{
+		size_t bucket_count = min_buckets;
+		while (bucket_count * 3 < n * 4)
+		{
+			bucket_count *= 2;
+		}
+		if (bucket_count > buckets.size())
+		{
+			rehash(bucket_count);
+		}
+	}
+
+	void clear()
+	{
+		slots.clear();
+		buckets.clear();
+		head = tail = free_head = npos;
+		count = 0;
+		bucket_bits = 0;
+	}
+
+	/**
+	 * \return pointer to the element with given [key] or nullptr, valid until the element is erased
+	 */
+	T* find(Key const& key)
+	{
+		const size_t i = find_bucket(key, mix(hasher(key)));
+		return i == npos ? nullptr : &slots[buckets[i].slot].value;
+	}
+
+	T const* find(Key const& key) const
+	{
+		return const_cast<flat_ordered_table*>(this)->find(key);
+	}
+
+	size_t count_of(Key const& key) const
+	{
+		return find(key) ? 1 : 0;
+	}
+
+	/**
+	 * \brief Appends [value] unless an element with the same key is present.
+	 * \return pointer to the element with the key of [value] and whether it was inserted
+	 */
+	std::pair<T*, bool> insert(T const& value)
+	{
+		const uint32_t hash = mix(hasher(key_of(value)));
+		const size_t i = find_bucket(key_of(value), hash);
+		if (i != npos)
+		{
+			return {&slots[buckets[i].slot].value, false};
+		}
+		reserve(count + 1);
+		const index_t index = allocate_slot(value);
+		place(index, hash);
+		++count;
+		return {&slots[index].value, true};
+	}
+
+	bool erase(Key const& key)
+	{
+		const size_t i = find_bucket(key, mix(hasher(key)));
+		if (i == npos)
+		{
+			return false;
+		}
+		release_slot(buckets[i].slot);
+		erase_bucket(i);
+		--count;
+		return true;
+	}
+
+	/**
+	 * \return approximate number of bytes owned by the table
+	 */
+	size_t memory_usage() const noexcept
+	{
+		return slots.size() * sizeof(slot) + buckets.capacity() * sizeof(bucket);
+	}
+};
+}	 // namespace detail
+
+/**
+ * \brief Insertion-ordered map storing small trivially copyable keys and values inline, see detail::flat_ordered_table.
+ */
+template <typename K, typename V, typename Hash = hash<K>, typename KeyEqual = std::equal_to<K>>
+using flat_ordered_map = detail::flat_ordered_table<detail::flat_entry<K, V>, K, detail::select_first, Hash, KeyEqual>;
+
+/**
+ * \brief Insertion-ordered set storing small trivially copyable elements inline, see detail::flat_ordered_table.
+ */
+template <typename T, typename Hash = hash<T>, typename KeyEqual = std::equal_to<T>>
+using flat_ordered_set = detail::flat_ordered_table<T, T, detail::select_self, Hash, KeyEqual>;
+}	 // namespace rd
+
+#endif	  // RD_CPP_FLAT_ORDERED_MAP_H
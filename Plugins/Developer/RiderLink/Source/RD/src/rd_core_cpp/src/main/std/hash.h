@@ -3,17 +3,38 @@
 
 #include <cstddef>
 #include <functional>
+#include <type_traits>
 
 namespace rd
 {
 template <typename T>
 struct hash
 {
+	// marks the default which relies on std::hash, see [util::is_hashable]
+	using std_hash = std::hash<T>;
+
 	size_t operator()(const T& value) const noexcept
 	{
 		return std::hash<T>()(value);
 	}
 };
+
+namespace util
+{
+/**
+ * \brief Whether rd::hash<T> can be used: it's specialized for [T] or std::hash<T> is enabled.
+ */
+template <typename T, typename = void>
+struct is_hashable : std::true_type
+{
+};
+
+template <typename T>
+struct is_hashable<T, std::enable_if_t<std::is_same<typename hash<T>::std_hash, std::hash<T>>::value>>
+	: std::is_default_constructible<std::hash<T>>
+{
+};
+}	 // namespace util
 }	 // namespace rd
 
 #endif	  // RD_CPP_HASH_H
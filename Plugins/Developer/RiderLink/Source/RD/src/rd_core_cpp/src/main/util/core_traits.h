@@ -5,6 +5,7 @@
 
 #include <type_traits>
 #include <string>
+#include <cstdint>
 
 namespace rd
 {
@@ -96,6 +97,28 @@ constexpr bool is_pod_v = std::is_trivial<T>::value && std::is_standard_layout<T
 template <typename T>
 /*inline */ constexpr bool is_void = std::is_same<T, Void>::value;
 
+// region trivially_serializable
+
+/**
+ * \brief Whether wire representation of [T] is exactly its object representation, so that arrays of [T] may be
+ * "SerDes"-ed by a single bulk copy. Specialize with std::true_type for own structs which are trivially copyable
+ * and have no padding, so that fields lay out in memory the same way as they follow on the wire.
+ */
+template <typename T, typename = void>
+struct is_trivially_serializable
+	: bool_constant<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, wchar_t>::value>
+{
+};
+
+template <typename T>
+/*inline */ constexpr bool is_trivially_serializable_v = is_trivially_serializable<T>::value;
+
+static_assert(is_trivially_serializable_v<int32_t>, "int32_t should be trivially serializable");
+static_assert(!is_trivially_serializable_v<bool>, "bool is written as checked byte");
+static_assert(!is_trivially_serializable_v<std::wstring>, "std::wstring shouldn't be trivially serializable");
+
+// endregion
+
 // region in_heap
 
 template <typename T>
@@ -110,6 +133,22 @@ static_assert(!in_heap_v<int>, "int shouldn't be placed in shared memory");
 
 // endregion
 
+// region inline_storable
+
+/**
+ * \brief Whether [T] may be kept inline by InlineStorage collections: trivially copyable and at most 32 bytes.
+ */
+template <typename T>
+using is_inline_storable = bool_constant<std::is_trivially_copyable<T>::value && !in_heap<T>::value && sizeof(T) <= 32>;
+
+template <typename T>
+/*inline */ constexpr bool is_inline_storable_v = is_inline_storable<T>::value;
+
+static_assert(is_inline_storable_v<int64_t>, "int64_t should be inline storable");
+static_assert(!is_inline_storable_v<std::wstring>, "std::wstring shouldn't be inline storable");
+
+// endregion
+
 // region literal
 
 template <typename T>
@@ -2,6 +2,7 @@
 #define RD_CPP_CORE_CPP_UTIL_H
 
 #include "erase_if.h"
+#include "function_ref.h"
 #include "gen_util.h"
 #include "overloaded.h"
 #include "shared_function.h"
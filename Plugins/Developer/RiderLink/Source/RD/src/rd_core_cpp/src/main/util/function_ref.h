@@ -0,0 +1,53 @@
+#ifndef RD_CPP_FUNCTION_REF_H
+#define RD_CPP_FUNCTION_REF_H
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace rd
+{
+namespace util
+{
+template <class F>
+class function_ref;
+
+/**
+ * \brief Non-owning reference to a callable. Unlike std::function it never allocates and is invoked
+ * through a single indirect call, so it fits parameters which are called before the callee returns.
+ * Referenced callable must outlive the function_ref.
+ */
+template <class R, class... Args>
+class function_ref<R(Args...)>
+{
+	void* callable = nullptr;
+
+	R (*invoker)(void*, Args...) = nullptr;
+
+	template <class F>
+	static R invoke(void* callable, Args... args)
+	{
+		return (*static_cast<F*>(callable))(std::forward<Args>(args)...);
+	}
+
+public:
+	template <class F, typename = typename std::enable_if_t<!std::is_same<std::decay_t<F>, function_ref>::value>>
+	function_ref(F&& f) noexcept
+		: callable(const_cast<void*>(static_cast<void const*>(std::addressof(f))))
+		, invoker(&invoke<std::remove_reference_t<F>>)
+	{
+	}
+
+	function_ref(function_ref const&) noexcept = default;
+
+	function_ref& operator=(function_ref const&) noexcept = default;
+
+	R operator()(Args... args) const
+	{
+		return invoker(callable, std::forward<Args>(args)...);
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_FUNCTION_REF_H
@@ -6,17 +6,21 @@
 #include "base/IProtocol.h"
 //#include "serialization/SerializationCtx.h"
 
+#include "spdlog/spdlog.h"
+
 #include <utility>
 
 namespace rd
 {
 IProtocol::IProtocol()
 {
+	set_loggers(nullptr, nullptr);
 }
 
 IProtocol::IProtocol(std::shared_ptr<Identities> identity, IScheduler* scheduler, std::shared_ptr<IWire> wire)
 	: identity(std::move(identity)), scheduler(scheduler), wire(std::move(wire))
 {
+	set_loggers(nullptr, nullptr);
 }
 
 const IProtocol* IProtocol::get_protocol() const
@@ -39,6 +43,22 @@ const Serializers& IProtocol::get_serializers() const
 	return *serializers;
 }
 
+void IProtocol::set_loggers(std::shared_ptr<spdlog::logger> received, std::shared_ptr<spdlog::logger> send)
+{
+	log_received = received ? std::move(received) : spdlog::get("logReceived");
+	log_send = send ? std::move(send) : spdlog::get("logSend");
+}
+
+spdlog::logger* IProtocol::get_log_received() const
+{
+	return log_received.get();
+}
+
+spdlog::logger* IProtocol::get_log_send() const
+{
+	return log_send.get();
+}
+
 const Identities* IProtocol::get_identity() const
 {
 	return identity.get();
@@ -16,6 +16,11 @@
 
 #include <rd_framework_export.h>
 
+namespace spdlog
+{
+class logger;
+}
+
 namespace rd
 {
 // region predeclared
@@ -39,6 +44,9 @@ protected:
 	std::shared_ptr<Identities> identity;
 	IScheduler* scheduler = nullptr;
 
+	std::shared_ptr<spdlog::logger> log_received;
+	std::shared_ptr<spdlog::logger> log_send;
+
 public:
 	std::shared_ptr<IWire> wire;
 	// region ctor/dtor
@@ -64,6 +72,16 @@ public:
 
 	const Serializers& get_serializers() const;
 
+	/**
+	 * \brief Routes the traces of entities bound to this protocol to [received] and [send] instead of the global
+	 * "logReceived" and "logSend" loggers. Null restores the global one.
+	 */
+	void set_loggers(std::shared_ptr<spdlog::logger> received, std::shared_ptr<spdlog::logger> send);
+
+	spdlog::logger* get_log_received() const;
+
+	spdlog::logger* get_log_send() const;
+
 	const RName& get_location() const override;
 };
 }	 // namespace rd
@@ -0,0 +1,44 @@
+#include "IWire.h"
+
+namespace rd
+{
+void IWire::send_inline(RdId const& id, util::function_ref<void(Buffer& buffer)> writer) const
+{
+	send(id, [writer](Buffer& buffer) { writer(buffer); });
+}
+
+void IWire::write_frame(Buffer& frames, RdId const& id, util::function_ref<void(Buffer& buffer)> writer)
+{
+	const size_t start = frames.get_position();
+	frames.write_integral<int32_t>(0);	  // placeholder for length
+	id.write(frames);
+	frames.write_integral<int16_t>(0);	  // placeholder for context
+	writer(frames);
+
+	const size_t end = frames.get_position();
+	frames.set_position(start);
+	frames.write_integral<int32_t>(static_cast<int32_t>(end - start - sizeof(int32_t)));
+	frames.set_position(end);
+}
+
+void IWire::send_frames(Buffer::ByteArray frames) const
+{
+	constexpr size_t header_size = sizeof(int64_t) + sizeof(int16_t);
+	Buffer buffer(std::move(frames));
+	const size_t end = buffer.get_data().size();
+	while (buffer.get_position() < end)
+	{
+		const size_t length = static_cast<size_t>(buffer.read_integral<int32_t>());
+		const size_t payload_start = buffer.get_position() + header_size;
+		const RdId id = RdId::read(buffer);
+		send_inline(id, [&buffer, payload_start, length](Buffer& out) {
+			out.write_raw(buffer.data() + payload_start, length - header_size);
+		});
+		buffer.set_position(payload_start + length - header_size);
+	}
+}
+
+void IWire::set_priority(Lifetime /*lifetime*/, RdId const& /*id*/, SendPriority /*priority*/) const
+{
+}
+}	 // namespace rd
@@ -14,6 +14,18 @@
 
 namespace rd
 {
+/**
+ * \brief Send priority class of an entity's messages, see [IWire::set_priority].
+ */
+enum class SendPriority : uint8_t
+{
+	// small interactive messages: calls, user requests
+	High,
+	Normal,
+	// streams which may fall behind, e.g. logs
+	Bulk
+};
+
 /**
  * \brief Sends and receives serialized object data over a network or a similar connection.
  */
@@ -39,6 +51,35 @@ public:
 	 */
 	virtual void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const = 0;
 
+	/**
+	 * \brief Same as [send], but [writer] is passed by reference instead of being type-erased into std::function,
+	 * so hot paths avoid closure allocation. Wires invoke [writer] before return, as [send] callers capture by reference.
+	 * Default implementation delegates to [send].
+	 * \param id of recipient.
+	 * \param writer is used to serialise data before send.
+	 */
+	virtual void send_inline(RdId const& id, util::function_ref<void(Buffer& buffer)> writer) const;
+
+	/**
+	 * \brief Appends a message to the given [id] written by [writer] to [frames] in the package format of SocketWire:
+	 * int32 length of the rest, id, int16 context placeholder, payload.
+	 */
+	static void write_frame(Buffer& frames, RdId const& id, util::function_ref<void(Buffer& buffer)> writer);
+
+	/**
+	 * \brief Sends messages serialized ahead of time by [write_frame], in order, as if each was passed to [send_inline].
+	 * Default implementation splits [frames] and sends them one by one.
+	 * \param frames concatenated frames
+	 */
+	virtual void send_frames(Buffer::ByteArray frames) const;
+
+	/**
+	 * \brief Sends messages of the entity with the given [id] with [priority] until [lifetime] is terminated.
+	 * Messages of entities with different priorities may overtake each other, messages of one entity never do.
+	 * Default implementation sends everything in order.
+	 */
+	virtual void set_priority(Lifetime lifetime, RdId const& id, SendPriority priority) const;
+
 	/**
 	 * \brief Adds a [handler] for receiving updated values of the object with the given [id]. The handler is removed
 	 * when the given [lifetime] is terminated.
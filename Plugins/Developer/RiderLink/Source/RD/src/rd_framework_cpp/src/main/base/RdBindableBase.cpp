@@ -14,6 +14,12 @@ bool RdBindableBase::is_bound() const
 	return parent != nullptr;
 }
 
+RName const& RdBindableBase::not_bound_location()
+{
+	static const RName location("<<not bound>>");
+	return location;
+}
+
 void RdBindableBase::bind(Lifetime lf, IRdDynamic const* parent, string_view name) const
 {
 	RD_ASSERT_MSG(!is_bound(), ("Trying to bind already bound this to " + to_string(parent->get_location())));
@@ -22,10 +28,14 @@ void RdBindableBase::bind(Lifetime lf, IRdDynamic const* parent, string_view nam
 			this->parent = parent;
 			location = parent->get_location().sub(name, ".");
 			this->bind_lifetime = lf;
+			cache_protocol(parent->get_protocol());
+			bound_context = &parent->get_serialization_context();
 		},
 		[this, lf]() {
 			this->bind_lifetime = lf;
 			location = location.sub("<<unbound>>", "::");
+			cache_protocol(nullptr);
+			bound_context = nullptr;
 			this->parent = nullptr;
 			rdid = RdId::Null();
 		});
@@ -42,14 +52,75 @@ void RdBindableBase::identify(const Identities& identities, RdId const& id) cons
 	RD_ASSERT_MSG(!id.isNull(), "Assigned RdId mustn't be null, entities: $this");
 
 	this->rdid = id;
+	identify_extensions(identities);
+}
+
+std::vector<RdBindableBase::extension_entry> RdBindableBase::extensions_snapshot() const
+{
+	std::vector<extension_entry> snapshot;
+	std::lock_guard<std::mutex> guard(extensions_guard.lock);
+	snapshot.reserve(bindable_extensions.size());
 	for (const auto& it : bindable_extensions)
 	{
-		identifyPolymorphic(*(it.second), identities, id.mix(".").mix(it.first));
+		snapshot.push_back(it.second);
+	}
+	return snapshot;
+}
+
+void RdBindableBase::identify_extensions(const Identities& identities) const
+{
+	for (const auto& it : extensions_snapshot())
+	{
+		identifyPolymorphic(*(it.value), identities, rdid.mix(it.suffix));
+	}
+}
+
+void RdBindableBase::bind_extensions(Lifetime lifetime) const
+{
+	for (const auto& it : extensions_snapshot())
+	{
+		bindPolymorphic(*(it.value), lifetime, this, it.name);
+	}
+}
+
+IRdBindable const* RdBindableBase::find_extension(util::hash_t hash, string_view name) const
+{
+	auto it = bindable_extensions.find(hash);
+	if (it == bindable_extensions.end())
+	{
+		return nullptr;
 	}
+	RD_ASSERT_MSG(it->second.name == name,
+		"Extensions " + it->second.name + " and " + std::string(name) + " of " + to_string(location) + " have the same id");
+	return it->second.value.get();
+}
+
+bool RdBindableBase::add_extension(extension_key const& key, std::shared_ptr<IRdBindable> extension) const
+{
+	auto& entry = bindable_extensions[key.hash];
+	entry = extension_entry{std::string(key.name), key.suffix, std::move(extension)};
+	return bind_lifetime.has_value();
+}
+
+void RdBindableBase::bind_extension(extension_key const& key, IRdBindable const& extension) const
+{
+	extension.identify(*get_protocol()->get_identity(), rdid.mix(key.suffix));
+	extension.bind(*bind_lifetime, this, key.name);
+}
+
+void RdBindableBase::cache_protocol(const IProtocol* protocol) const
+{
+	bound_protocol = protocol;
+	bound_wire = protocol ? protocol->get_wire() : nullptr;
+	bound_scheduler = protocol ? protocol->get_scheduler() : nullptr;
 }
 
 const IProtocol* RdBindableBase::get_protocol() const
 {
+	if (bound_protocol != nullptr)
+	{
+		return bound_protocol;
+	}
 	if (is_bound())
 	{
 		auto protocol = parent->get_protocol();
@@ -78,6 +149,10 @@ void RdBindableBase::set_id(RdId id) const
 
 SerializationCtx& RdBindableBase::get_serialization_context() const
 {
+	if (bound_context != nullptr)
+	{
+		return *bound_context;
+	}
 	if (is_bound())
 	{
 		return parent->get_serialization_context();
@@ -90,12 +165,6 @@ SerializationCtx& RdBindableBase::get_serialization_context() const
 
 void RdBindableBase::init(Lifetime lifetime) const
 {
-	for (const auto& it : bindable_extensions)
-	{
-		if (it.second != nullptr)
-		{
-			bindPolymorphic(*(it.second), lifetime, this, it.first);
-		}
-	}
+	bind_extensions(lifetime);
 }
 }	 // namespace rd
@@ -11,12 +11,68 @@
 
 #include "thirdparty.hpp"
 
+#include <mutex>
+#include <vector>
+
 #include <rd_framework_export.h>
 
 namespace rd
 {
+/**
+ * \brief Name of an extension together with everything derived from it, computable at compile time for constant names.
+ */
+struct extension_key
+{
+	string_view name;
+	// mixes ".name" into the owner's id
+	RdId::Suffix suffix;
+	util::hash_t hash;
+
+	constexpr explicit extension_key(string_view name)
+		: name(name), suffix(util::getPlatformIndependentHashSuffix(name, RdId::suffix("."))), hash(util::getPlatformIndependentHash(name))
+	{
+	}
+};
+
 class RD_FRAMEWORK_API RdBindableBase : public virtual IRdBindable /*, IPrintable*/
 {
+public:
+	struct extension_entry
+	{
+		std::string name;
+		RdId::Suffix suffix;
+		std::shared_ptr<IRdBindable> value;
+	};
+
+private:
+	// guards bindable_extensions, the owner itself is still moved only while nobody else can see it
+	struct extensions_lock
+	{
+		mutable std::mutex lock;
+
+		extensions_lock() = default;
+
+		extensions_lock(extensions_lock&&) noexcept
+		{
+		}
+
+		extensions_lock& operator=(extensions_lock&&) noexcept
+		{
+			return *this;
+		}
+	};
+
+	extensions_lock extensions_guard;
+
+	IRdBindable const* find_extension(util::hash_t hash, string_view name) const;
+
+	// returns whether the owner is bound, the caller then binds the extension once the lock is released
+	bool add_extension(extension_key const& key, std::shared_ptr<IRdBindable> extension) const;
+
+	void bind_extension(extension_key const& key, IRdBindable const& extension) const;
+
+	std::vector<extension_entry> extensions_snapshot() const;
+
 protected:
 	mutable RName location;
 	mutable IRdDynamic const* parent = nullptr;
@@ -24,16 +80,30 @@ protected:
 
 	mutable optional<Lifetime> bind_lifetime;
 
+	// resolved on bind and reset on unbind, so that sends don't walk up the parent chain
+	mutable const IProtocol* bound_protocol = nullptr;
+	mutable const IWire* bound_wire = nullptr;
+	mutable IScheduler* bound_scheduler = nullptr;
+	mutable SerializationCtx* bound_context = nullptr;
+
+	void cache_protocol(const IProtocol* protocol) const;
+
 	bool is_bound() const;
 
 	const IProtocol* get_protocol() const override;
 
 	virtual std::string toString() const;
 
+	static RName const& not_bound_location();
+
+	void identify_extensions(const Identities& identities) const;
+
+	void bind_extensions(Lifetime lifetime) const;
+
 public:
 	// region ctor/dtor
 
-	RdBindableBase() : location("<<not bound>>")
+	RdBindableBase() : location(not_bound_location())
 	{
 	}
 
@@ -59,28 +129,41 @@ public:
 
 	SerializationCtx& get_serialization_context() const override;
 
-	mutable ordered_map<std::string, std::shared_ptr<IRdBindable>> bindable_extensions;	   // TO-DO concurrency
-	// mutable std::map<std::string, std::any> non_bindable_extensions;//TO-DO concurrency
+	/**
+	 * \brief Extensions created so far, keyed by hash of their names.
+	 * \details Extensions are created on the first getOrCreateExtension. Those created before the owner is bound are
+	 * bound together with it, later ones right after creation. The lock only guards the table: identify and bind run
+	 * outside of it, as an extension's init may create further extensions or wait for other threads.
+	 */
+	mutable ordered_map<util::hash_t, extension_entry> bindable_extensions;
 
 	template <typename T, typename... Args>
-	auto getOrCreateExtension(std::string name, Args&&... args) const ->
+	auto getOrCreateExtension(extension_key const& key, Args&&... args) const ->
 		typename std::enable_if_t<util::is_base_of_v<IRdBindable, T>, T> const&
 	{
-		auto it = bindable_extensions.find(name);
-		if (it != bindable_extensions.end())
+		std::shared_ptr<T> new_extension;
+		bool bound;
 		{
-			return *dynamic_cast<T const*>(it->second.get());
+			std::lock_guard<std::mutex> guard(extensions_guard.lock);
+			if (IRdBindable const* existing = find_extension(key.hash, key.name))
+			{
+				return *dynamic_cast<T const*>(existing);
+			}
+			new_extension = std::make_shared<T>(std::forward<Args>(args)...);
+			bound = add_extension(key, new_extension);
 		}
-		std::shared_ptr<T> new_extension = std::make_shared<T>(std::forward<Args>(args)...);
-		T const& res = *new_extension.get();
-		if (bind_lifetime.has_value())
+		if (bound)
 		{
-			auto protocol = get_protocol();
-			new_extension->identify(*protocol->get_identity(), rdid.mix(".").mix(name));
-			new_extension->bind(*bind_lifetime, this, name);
+			bind_extension(key, *new_extension);
 		}
-		bindable_extensions.emplace(name, std::move(new_extension));
-		return res;
+		return *new_extension;
+	}
+
+	template <typename T, typename... Args>
+	auto getOrCreateExtension(string_view name, Args&&... args) const ->
+		typename std::enable_if_t<util::is_base_of_v<IRdBindable, T>, T> const&
+	{
+		return getOrCreateExtension<T>(extension_key(name), std::forward<Args>(args)...);
 	}
 
 	/* template<typename T>
@@ -21,12 +21,99 @@ protected:
 	mutable int32_t master_version = 0;
 	mutable bool default_value_changed = false;
 
+	// kinds of updates sent when send_patches is set
+	static const int8_t fullUpdate = 0;
+	static const int8_t patchUpdate = 1;
+	static const int8_t resyncRequest = 2;
+
+	// value replaced by the local change being sent, the base of its patch
+	mutable property_storage<T> patch_base;
+
+	using patchable = util::has_patch<S, T>;
+
+	static int64_t base_hash(T const& value)
+	{
+		return static_cast<int64_t>(hash<T>()(value));
+	}
+
+	void write_value(Buffer& buffer, T const& v) const
+	{
+		buffer.require_available(serialized_size_of<S>(this->get_serialization_context(), v));
+		S::write(this->get_serialization_context(), buffer, v);
+	}
+
+	void write_update(Buffer& buffer, T const& v, std::true_type) const
+	{
+		if (patch_base)
+		{
+			buffer.write_integral<int8_t>(static_cast<int8_t>(patchUpdate));
+			buffer.write_integral<int64_t>(base_hash(*patch_base));
+			S::write_patch(this->get_serialization_context(), buffer, *patch_base, v);
+			return;
+		}
+		write_update(buffer, v, std::false_type{});
+	}
+
+	void write_update(Buffer& buffer, T const& v, std::false_type) const
+	{
+		buffer.write_integral<int8_t>(static_cast<int8_t>(fullUpdate));
+		write_value(buffer, v);
+	}
+
+	/**
+	 * \return the patched value, or nullopt if the patch was made against a value this side doesn't hold
+	 */
+	optional<WT> read_patch(Buffer& buffer, std::true_type) const
+	{
+		const int64_t hash = buffer.read_integral<int64_t>();
+		if (!this->has_value() || base_hash(this->get()) != hash)
+		{
+			return nullopt;
+		}
+		return optional<WT>(S::read_patch(this->get_serialization_context(), buffer, this->get()));
+	}
+
+	optional<WT> read_patch(Buffer& /*buffer*/, std::false_type) const
+	{
+		RD_ASSERT_MSG(false, "Received patch for property " + to_string(location) + " whose serializer can't read patches");
+		return nullopt;
+	}
+
+	void keep_patch_base(std::true_type) const
+	{
+		if (send_patches && this->has_value())
+		{
+			patch_base = this->value;
+		}
+	}
+
+	// nothing to patch against: updates of this property are always sent in full
+	void keep_patch_base(std::false_type) const
+	{
+	}
+
+	void send_full() const
+	{
+		get_wire()->send_inline(rdid, [this](Buffer& buffer) {
+			buffer.write_integral<int32_t>(master_version);
+			write_update(buffer, this->get(), std::false_type{});
+		});
+	}
+
 	// init
 public:
 	mutable bool optimize_nested = false;
 
 	bool is_master = false;
 
+	/**
+	 * \brief Send local changes as patches against the previous value if serializer [S] supports them
+	 * (types with write_patch and read_patch; rd-gen has to emit these for model classes).
+	 * \details A patch carries the hash of its base. A side holding a different value drops it and asks the counterpart
+	 * for the full value. Both sides must enable it.
+	 */
+	bool send_patches = false;
+
 	// region ctor/dtor
 
 	RdPropertyBase() = default;
@@ -78,10 +165,17 @@ public:
 			{
 				master_version++;
 			}
-			get_wire()->send(rdid, [this, &v](Buffer& buffer) {
+			get_wire()->send_inline(rdid, [this, &v](Buffer& buffer) {
 				buffer.write_integral<int32_t>(master_version);
-				S::write(this->get_serialization_context(), buffer, v);
-				spdlog::get("logSend")->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
+				if (send_patches)
+				{
+					write_update(buffer, v, patchable{});
+				}
+				else
+				{
+					write_value(buffer, v);
+				}
+				log_send()->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
 					std::to_string(master_version), to_string(v));
 			});
 		});
@@ -102,10 +196,47 @@ public:
 	void on_wire_received(Buffer buffer) const override
 	{
 		int32_t version = buffer.read_integral<int32_t>();
-		WT v = S::read(this->get_serialization_context(), buffer);
+		const int8_t kind = send_patches ? buffer.read_integral<int8_t>() : fullUpdate;
+		if (kind == resyncRequest)
+		{
+			if (this->has_value())
+			{
+				send_full();
+			}
+			return;
+		}
 
 		bool rejected = is_master && version < master_version;
-		spdlog::get("logSend")->trace("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
+		if (kind == patchUpdate)
+		{
+			if (rejected)
+			{
+				log_send()->trace("RECV property {} {}:: oldver={}, ver={}, patch >> REJECTED", to_string(location),
+					to_string(rdid), master_version, version);
+				return;
+			}
+			optional<WT> patched = read_patch(buffer, patchable{});
+			if (!patched)
+			{
+				log_send()->trace(
+					"RECV property {} {}:: ver={}, patch of another value, requesting resync", to_string(location), to_string(rdid), version);
+				get_wire()->send_inline(rdid, [this](Buffer& request) {
+					request.write_integral<int32_t>(master_version);
+					request.write_integral<int8_t>(static_cast<int8_t>(resyncRequest));
+				});
+				return;
+			}
+			log_send()->trace("RECV property {} {}:: oldver={}, ver={}, patched value = {}", to_string(location),
+				to_string(rdid), master_version, version, to_string(*patched));
+			master_version = version;
+
+			Property<T>::set(*std::move(patched));
+			return;
+		}
+
+		WT v = S::read(this->get_serialization_context(), buffer);
+
+		log_send()->trace("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
 			master_version, version, to_string(v), (rejected ? ">> REJECTED" : ""));
 		if (rejected)
 		{
@@ -129,7 +260,9 @@ public:
 	{
 		this->local_change([this, new_value = std::move(new_value)]() mutable {
 			this->default_value_changed = true;
+			keep_patch_base(patchable{});
 			Property<T>::set(std::move(new_value));
+			patch_base = property_storage<T>{};
 		});
 	}
 
@@ -23,7 +23,7 @@ RdReactiveBase& RdReactiveBase::operator=(RdReactiveBase&& other)
 
 const IWire* RdReactiveBase::get_wire() const
 {
-	return get_protocol()->get_wire();
+	return bound_wire != nullptr ? bound_wire : get_protocol()->get_wire();
 }
 
 void RdReactiveBase::assert_threading() const
@@ -42,6 +42,16 @@ void RdReactiveBase::assert_bound() const
 	}
 }
 
+spdlog::logger* RdReactiveBase::log_received() const
+{
+	return get_protocol()->get_log_received();
+}
+
+spdlog::logger* RdReactiveBase::log_send() const
+{
+	return get_protocol()->get_log_send();
+}
+
 const Serializers& RdReactiveBase::get_serializers() const
 {
 	return *get_protocol()->serializers.get();
@@ -49,7 +59,7 @@ const Serializers& RdReactiveBase::get_serializers() const
 
 IScheduler* RdReactiveBase::get_default_scheduler() const
 {
-	return get_protocol()->get_scheduler();
+	return bound_scheduler != nullptr ? bound_scheduler : get_protocol()->get_scheduler();
 }
 
 IScheduler* RdReactiveBase::get_wire_scheduler() const
@@ -53,6 +53,13 @@ public:
 
 	void assert_threading() const;
 
+	/**
+	 * \brief Loggers of the protocol this entity is bound to, for tracing what it receives and sends.
+	 */
+	spdlog::logger* log_received() const;
+
+	spdlog::logger* log_send() const;
+
 	void assert_bound() const;
 
 	template <typename F>
@@ -1,9 +1,16 @@
 #include "WireBase.h"
 
+#include "wire/ProtocolTrace.h"
+
 namespace rd
 {
 void WireBase::advise(Lifetime lifetime, const IRdReactive* entity) const
 {
 	message_broker.advise_on(lifetime, entity);
 }
+
+void WireBase::set_trace(std::shared_ptr<ProtocolTrace> trace)
+{
+	this->trace = std::move(trace);
+}
 }	 // namespace rd
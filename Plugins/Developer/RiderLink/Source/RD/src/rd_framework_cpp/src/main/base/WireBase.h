@@ -5,10 +5,14 @@
 #include "base/IWire.h"
 #include "protocol/MessageBroker.h"
 
+#include <memory>
+
 #include <rd_framework_export.h>
 
 namespace rd
 {
+class ProtocolTrace;
+
 class RD_FRAMEWORK_API WireBase : public IWire
 {
 protected:
@@ -16,6 +20,8 @@ protected:
 
 	MessageBroker message_broker;
 
+	std::shared_ptr<ProtocolTrace> trace;
+
 public:
 	// region ctor/dtor
 	explicit WireBase(IScheduler* scheduler) : scheduler(scheduler), message_broker(scheduler)
@@ -26,6 +32,12 @@ public:
 	// endregion
 
 	void advise(Lifetime lifetime, IRdReactive const* entity) const override;
+
+	/**
+	 * \brief Records messages sent and received by this wire to [trace].
+	 * Must be set before the wire is used.
+	 */
+	void set_trace(std::shared_ptr<ProtocolTrace> trace);
 };
 }	 // namespace rd
 
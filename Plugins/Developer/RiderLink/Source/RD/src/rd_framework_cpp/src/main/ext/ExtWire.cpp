@@ -9,20 +9,11 @@ ExtWire::ExtWire()
 	connected.advise(Lifetime::Eternal(), [this](bool b) {
 		if (b)
 		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			if (pending_frames.get_position() != 0)
 			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				while (true)
-				{
-					if (sendQ.empty())
-					{
-						return;
-					}
-					// auto[id, payload] = std::move(sendQ.front());
-					auto it = std::move(sendQ.front());
-					sendQ.pop();
-					realWire->send(
-						it.first, [payload = std::move(it.second)](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
-				}
+				// under the lock, so that messages sent meanwhile don't overtake the pending ones
+				realWire->send_frames(std::move(pending_frames).getRealArray());
 			}
 		}
 	});
@@ -34,17 +25,25 @@ void ExtWire::advise(Lifetime lifetime, IRdReactive const* entity) const
 }
 
 void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+{
+	send_inline(id, writer);
+}
+
+void ExtWire::send_inline(RdId const& id, util::function_ref<void(Buffer& buffer)> writer) const
 {
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
-		if (!sendQ.empty() || !connected.get())
+		if (pending_frames.get_position() != 0 || !connected.get())
 		{
-			Buffer buffer;
-			writer(buffer);
-			sendQ.emplace(id, buffer.getRealArray());
+			write_frame(pending_frames, id, writer);
 			return;
 		}
 	}
-	realWire->send(id, std::move(writer));
+	realWire->send_inline(id, writer);
+}
+
+void ExtWire::set_priority(Lifetime lifetime, RdId const& id, SendPriority priority) const
+{
+	realWire->set_priority(lifetime, id, priority);
 }
 }	 // namespace rd
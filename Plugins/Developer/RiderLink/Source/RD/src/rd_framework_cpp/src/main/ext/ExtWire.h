@@ -10,7 +10,6 @@
 #include "protocol/RdId.h"
 #include "protocol/Buffer.h"
 
-#include <queue>
 #include <mutex>
 #include <functional>
 
@@ -22,7 +21,8 @@ class RD_FRAMEWORK_API ExtWire final : public IWire
 {
 	mutable std::mutex lock;
 
-	mutable std::queue<std::pair<RdId, Buffer::ByteArray> > sendQ;
+	// messages sent before connect, as frames of IWire::write_frame
+	mutable Buffer pending_frames;
 
 public:
 	ExtWire();
@@ -32,6 +32,10 @@ public:
 	void advise(Lifetime lifetime, IRdReactive const* entity) const override;
 
 	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send_inline(RdId const& id, util::function_ref<void(Buffer& buffer)> writer) const override;
+
+	void set_priority(Lifetime lifetime, RdId const& id, SendPriority priority) const override;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
@@ -28,8 +28,13 @@ void RdExtBase::init(Lifetime lifetime) const
 		[&] {
 			extProtocol =
 				std::make_shared<Protocol>(parentProtocol->identity, sc, std::static_pointer_cast<IWire>(extWire), lifetime);
+			extProtocol->set_loggers(parentProtocol->log_received, parentProtocol->log_send);
+			cache_protocol(extProtocol.get());
 		},
-		[this] { extProtocol = nullptr; });
+		[this, parentProtocol] {
+			cache_protocol(parentProtocol);
+			extProtocol = nullptr;
+		});
 
 	parentWire->advise(lifetime, this);
 
@@ -38,17 +43,14 @@ void RdExtBase::init(Lifetime lifetime) const
 	lifetime->bracket([this, parentWire] { sendState(*parentWire, ExtState::Ready); },
 		[this, parentWire] { sendState(*parentWire, ExtState::Disconnected); });
 
-	for (auto const& it : bindable_extensions)
-	{
-		bindPolymorphic(*(it.second), lifetime, this, it.first);
-	}
+	bind_extensions(lifetime);
 	traceMe(Protocol::initializationLogger, "created and bound");
 }
 
 void RdExtBase::on_wire_received(Buffer buffer) const
 {
 	ExtState remoteState = buffer.read_enum<ExtState>();
-	traceMe(spdlog::get("logReceived"), "remote: " + to_string(remoteState));
+	traceMe(get_protocol()->log_received, "remote: " + to_string(remoteState));
 
 	switch (remoteState)
 	{
@@ -82,7 +84,7 @@ void RdExtBase::on_wire_received(Buffer buffer) const
 
 void RdExtBase::sendState(IWire const& wire, ExtState state) const
 {
-	wire.send(rdid, [&](Buffer& buffer) {
+	wire.send_inline(rdid, [&](Buffer& buffer) {
 		buffer.write_enum<ExtState>(state);
 		buffer.write_integral<int64_t>(serializationHash);
 	});
@@ -2,63 +2,218 @@
 
 #include "thirdparty.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
 namespace rd
 {
 class RNameImpl
 {
 public:
 	// region ctor/dtor
-	RNameImpl(RName parent, string_view localName, string_view separator);
+	RNameImpl(RNameImpl const* parent, string_view localName, string_view separator);
 
-	RNameImpl(const RName& other) = delete;
-	RNameImpl(RName&& other) noexcept = delete;
+	RNameImpl(const RNameImpl& other) = delete;
+	RNameImpl(RNameImpl&& other) noexcept = delete;
 	RNameImpl& operator=(const RNameImpl& other) = delete;
 	RNameImpl& operator=(RNameImpl&& other) noexcept = delete;
 	// endregion
 
-	friend std::string to_string(RNameImpl const& value);
+	std::string const& full_path() const;
+
+	RNameImpl const* const parent;
+	const std::string local_name, separator;
+
+	// names and child nodes referring to this node; once it drops to zero the node is never handed out again
+	mutable std::atomic<size_t> refs{1};
 
 private:
-	RName parent;
-	std::string local_name, separator;
+	mutable std::once_flag rendered;
+	mutable std::string path;
 };
 
-RNameImpl::RNameImpl(RName parent, string_view localName, string_view separator)
+RNameImpl::RNameImpl(RNameImpl const* parent, string_view localName, string_view separator)
 	: parent(parent), local_name(localName), separator(separator)
 {
 }
 
-RName::RName(RName parent, string_view localName, string_view separator)
-	: impl(std::make_shared<RNameImpl>(std::move(parent), localName, separator))
+std::string const& RNameImpl::full_path() const
 {
+	std::call_once(rendered, [this] {
+		if (parent)
+		{
+			path = parent->full_path();
+			path += separator;
+			path += local_name;
+		}
+		else
+		{
+			path = local_name;
+		}
+	});
+	return path;
 }
 
-RName RName::sub(string_view localName, string_view separator) const
+namespace
+{
+struct RNameKey
+{
+	RNameImpl const* parent;
+	string_view local_name;
+	string_view separator;
+
+	bool operator==(RNameKey const& other) const
+	{
+		return parent == other.parent && local_name == other.local_name && separator == other.separator;
+	}
+};
+
+struct RNameKeyHash
+{
+	size_t operator()(RNameKey const& key) const noexcept
+	{
+		uint64_t h = reinterpret_cast<uintptr_t>(key.parent);
+		for (char c : key.local_name)
+		{
+			h = h * 31 + static_cast<unsigned char>(c);
+		}
+		for (char c : key.separator)
+		{
+			h = h * 31 + static_cast<unsigned char>(c);
+		}
+		// spread sibling names over the buckets
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		return static_cast<size_t>(h);
+	}
+};
+
+class RNameArena
+{
+	std::mutex lock;
+	// keys of index point into the nodes they map to
+	std::unordered_map<RNameKey, RNameImpl const*, RNameKeyHash> index;
+
+	static bool try_acquire(RNameImpl const* node)
+	{
+		size_t refs = node->refs.load(std::memory_order_relaxed);
+		while (refs != 0)
+		{
+			if (node->refs.compare_exchange_weak(refs, refs + 1, std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	RNameImpl const* intern(RNameImpl const* parent, string_view localName, string_view separator)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = index.find(RNameKey{parent, localName, separator});
+		if (it != index.end())
+		{
+			if (try_acquire(it->second))
+			{
+				return it->second;
+			}
+			// the node is being released, its releaser won't find it in the index anymore
+			index.erase(it);
+		}
+		if (parent)
+		{
+			acquire(parent);
+		}
+		auto node = new RNameImpl(parent, localName, separator);
+		index.emplace(RNameKey{parent, node->local_name, node->separator}, node);
+		return node;
+	}
+
+	static void acquire(RNameImpl const* node)
+	{
+		node->refs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void release(RNameImpl const* node)
+	{
+		while (node && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				auto it = index.find(RNameKey{node->parent, node->local_name, node->separator});
+				if (it != index.end() && it->second == node)
+				{
+					index.erase(it);
+				}
+			}
+			RNameImpl const* parent = node->parent;
+			delete node;
+			node = parent;
+		}
+	}
+
+	static RNameArena& instance()
+	{
+		// leaked on purpose: names may be rendered and released from static destructors
+		static RNameArena* arena = new RNameArena();
+		return *arena;
+	}
+};
+}	 // namespace
+
+RName::RName(RName parent, string_view localName, string_view separator)
+	: impl(RNameArena::instance().intern(parent.impl, localName, separator))
 {
-	return RName(*this, localName, separator);
 }
 
-std::string to_string(RName const& value)
+RName::RName(const RName& other) : impl(other.impl)
 {
-	std::string res;
-	if (value.impl)
+	if (impl)
 	{
-		res = to_string(*value.impl);
+		RNameArena::acquire(impl);
 	}
-	return res;
 }
 
-std::string to_string(RNameImpl const& value)
+RName::RName(RName&& other) noexcept : impl(other.impl)
 {
-	if (value.parent)
+	other.impl = nullptr;
+}
+
+RName& RName::operator=(const RName& other)
+{
+	if (impl != other.impl)
 	{
-		std::string res;
-		res = to_string(value.parent);
-		res += value.separator;
-		res += value.local_name;
-		return res;
+		RName copy(other);
+		std::swap(impl, copy.impl);
 	}
-	return value.local_name;
+	return *this;
+}
+
+RName& RName::operator=(RName&& other) noexcept
+{
+	std::swap(impl, other.impl);
+	return *this;
+}
+
+RName::~RName()
+{
+	RNameArena::instance().release(impl);
+}
+
+RName RName::sub(string_view localName, string_view separator) const
+{
+	return RName(*this, localName, separator);
+}
+
+std::string const& to_string(RName const& value)
+{
+	static const std::string empty;
+	return value.impl ? value.impl->full_path() : empty;
 }
 
 RName::RName(string_view local_name) : RName(RName(), local_name, "")
@@ -17,6 +17,10 @@ class RNameImpl;
 
 /**
  * \brief Recursive name. For constructs like Aaaa.Bbb::CCC
+ *
+ * \details Names are hash-consed in a global arena: equal names share one node, so comparing is O(1),
+ * and the full path is rendered once on first use. Nodes are reference counted: a node is freed together with
+ * the last name referring to it or to one of its children, so dynamic segments like map keys don't accumulate.
  */
 class RD_FRAMEWORK_API RName
 {
@@ -25,13 +29,15 @@ public:
 
 	RName() = default;
 
-	RName(const RName& other) = default;
+	RName(const RName& other);
 
-	RName(RName&& other) noexcept = default;
+	RName(RName&& other) noexcept;
 
-	RName& operator=(const RName& other) = default;
+	RName& operator=(const RName& other);
 
-	RName& operator=(RName&& other) noexcept = default;
+	RName& operator=(RName&& other) noexcept;
+
+	~RName();
 
 	RName(RName parent, string_view localName, string_view separator);
 
@@ -45,10 +51,20 @@ public:
 		return impl != nullptr;
 	}
 
-	friend std::string RD_FRAMEWORK_API to_string(RName const& value);
+	friend bool operator==(RName const& lhs, RName const& rhs)
+	{
+		return lhs.impl == rhs.impl;
+	}
+
+	friend bool operator!=(RName const& lhs, RName const& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	friend RD_FRAMEWORK_API std::string const& to_string(RName const& value);
 
 private:
-	std::shared_ptr<RNameImpl> impl;
+	RNameImpl const* impl = nullptr;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
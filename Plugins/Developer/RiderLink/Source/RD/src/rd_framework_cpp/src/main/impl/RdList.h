@@ -37,6 +37,76 @@ private:
 			   " :: value = " + (value ? to_string(*value) : "");
 	}
 
+	void identify(T const* new_value) const
+	{
+		if (!optimize_nested)
+		{
+			const IProtocol* iProtocol = get_protocol();
+			const Identities* identity = iProtocol->get_identity();
+			identifyPolymorphic(*new_value, *identity, identity->next(rdid));
+		}
+	}
+
+	int64_t next_header(Op op) const
+	{
+		return static_cast<int64_t>(op) | (next_version++ << (range_ops ? rangeOpsFlagShift : versionedFlagShift));
+	}
+
+	void send_op(Op op, int32_t index, T const* new_value) const
+	{
+		get_wire()->send_inline(rdid, [&](Buffer& buffer) {
+			const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+			buffer.write_integral<int64_t>(next_header(op), encoding);
+			buffer.write_integral<int32_t>(index, encoding);
+
+			if (new_value)
+			{
+				buffer.require_available(serialized_size_of<S>(this->get_serialization_context(), *new_value));
+				S::write(this->get_serialization_context(), buffer, *new_value);
+			}
+			log_send()->trace(logmsg(op, next_version - 1, index, new_value));
+		});
+	}
+
+	void send_range(Op op, int32_t index, size_t count, std::vector<T const*> const* new_values) const
+	{
+		get_wire()->send_inline(rdid, [&](Buffer& buffer) {
+			const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+			buffer.write_integral<int64_t>(next_header(op), encoding);
+			buffer.write_integral<int32_t>(index, encoding);
+			buffer.write_integral<int32_t>(static_cast<int32_t>(count), encoding);
+
+			if (new_values)
+			{
+				size_t size = 0;
+				for (T const* new_value : *new_values)
+				{
+					size += serialized_size_of<S>(this->get_serialization_context(), *new_value);
+				}
+				buffer.require_available(size);
+				for (T const* new_value : *new_values)
+				{
+					S::write(this->get_serialization_context(), buffer, *new_value);
+				}
+			}
+			log_send()->trace(logmsg(op, next_version - 1, index) + " :: count = " + std::to_string(count));
+		});
+	}
+
+	void send_remove_range(int32_t index, size_t count) const
+	{
+		if (range_ops)
+		{
+			send_range(Op::REMOVE_RANGE, index, count, nullptr);
+			return;
+		}
+		// one message per element, back to front, as a peer without range ops expects
+		for (size_t i = count; i > 0; --i)
+		{
+			send_op(Op::REMOVE, static_cast<int32_t>(index + i - 1), nullptr);
+		}
+	}
+
 public:
 	using Event = typename IViewableList<T>::Event;
 
@@ -52,10 +122,10 @@ public:
 	virtual ~RdList() = default;
 	// endregion
 
-	static RdList<T, S> read(SerializationCtx& /*ctx*/, Buffer& buffer)
+	static RdList<T, S> read(SerializationCtx& ctx, Buffer& buffer)
 	{
 		RdList<T, S> result;
-		int64_t next_version = buffer.read_integral<int64_t>();
+		int64_t next_version = buffer.read_integral<int64_t>(ctx.get_integer_encoding());
 		RdId id = RdId::read(buffer);
 
 		result.next_version = next_version;
@@ -63,49 +133,62 @@ public:
 		return result;
 	}
 
-	void write(SerializationCtx& /*ctx*/, Buffer& buffer) const override
+	void write(SerializationCtx& ctx, Buffer& buffer) const override
 	{
-		buffer.write_integral<int64_t>(next_version);
+		buffer.write_integral<int64_t>(next_version, ctx.get_integer_encoding());
 		rdid.write(buffer);
 	}
 
 	static const int32_t versionedFlagShift = 2;	// update when changing Op
 
+	static const int32_t rangeOpsFlagShift = 3;	   // wider op field, used when range_ops is set
+
 	bool optimize_nested = false;
 
+	/**
+	 * \brief Send range events as single Op::ADD_RANGE/Op::REMOVE_RANGE messages instead of one message per element.
+	 * The current elements replayed on bind then go as one Op::ADD_RANGE snapshot as well.
+	 * Changes the message header layout, so both sides must enable it.
+	 */
+	bool range_ops = false;
+
 	void init(Lifetime lifetime) const override
 	{
 		RdBindableBase::init(lifetime);
 
 		local_change([this, lifetime] {
-			advise(lifetime, [this, lifetime](typename IViewableList<T>::Event e) {
+			advise(lifetime, [this](Event const& e) {
 				if (!is_local_change)
 					return;
 
-				if (!optimize_nested)
-				{
-					T const* new_value = e.get_new_value();
-					if (new_value)
-					{
-						const IProtocol* iProtocol = get_protocol();
-						const Identities* identity = iProtocol->get_identity();
-						identifyPolymorphic(*new_value, *identity, identity->next(rdid));
-					}
-				}
-
-				get_wire()->send(rdid, [this, e](Buffer& buffer) {
-					Op op = static_cast<Op>(e.v.index());
-
-					buffer.write_integral<int64_t>(static_cast<int64_t>(op) | (next_version++ << versionedFlagShift));
-					buffer.write_integral<int32_t>(static_cast<const int32_t>(e.get_index()));
-
-					T const* new_value = e.get_new_value();
-					if (new_value)
-					{
-						S::write(this->get_serialization_context(), buffer, *new_value);
-					}
-					spdlog::get("logSend")->trace(logmsg(op, next_version - 1, e.get_index(), new_value));
-				});
+				visit(util::make_visitor(
+						  [this](typename Event::Add const& e) {
+							  identify(e.new_value);
+							  send_op(Op::ADD, e.index, e.new_value);
+						  },
+						  [this](typename Event::Update const& e) {
+							  identify(e.new_value);
+							  send_op(Op::UPDATE, e.index, e.new_value);
+						  },
+						  [this](typename Event::Remove const& e) { send_op(Op::REMOVE, e.index, nullptr); },
+						  [this](typename Event::AddRange const& e) {
+							  for (T const* new_value : e.new_values)
+							  {
+								  identify(new_value);
+							  }
+							  if (range_ops)
+							  {
+								  send_range(Op::ADD_RANGE, e.index, e.new_values.size(), &e.new_values);
+								  return;
+							  }
+							  for (size_t i = 0; i < e.new_values.size(); ++i)
+							  {
+								  send_op(Op::ADD, static_cast<int32_t>(e.index + i), e.new_values[i]);
+							  }
+						  },
+						  [this](typename Event::RemoveRange const& e) { send_remove_range(e.index, e.old_values.size()); },
+						  [this](typename Event::Reset const& e) { send_remove_range(0, e.old_values.size()); }),
+					e.v);
 			});
 		});
 
@@ -121,10 +204,12 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int64_t header = (buffer.read_integral<int64_t>());
-		int64_t version = header >> versionedFlagShift;
-		Op op = static_cast<Op>((header & ((1 << versionedFlagShift) - 1L)));
-		int32_t index = (buffer.read_integral<int32_t>());
+		const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+		const int32_t flagShift = range_ops ? rangeOpsFlagShift : versionedFlagShift;
+		int64_t header = (buffer.read_integral<int64_t>(encoding));
+		int64_t version = header >> flagShift;
+		Op op = static_cast<Op>((header & ((1 << flagShift) - 1L)));
+		int32_t index = (buffer.read_integral<int32_t>(encoding));
 
 		RD_ASSERT_MSG(version == next_version,
 			("Version conflict for " + to_string(location) + "}. Expected version " + std::to_string(next_version) + ", received " +
@@ -138,7 +223,7 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				log_received()->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
 
 				(index < 0) ? list::add(std::move(value)) : list::add(static_cast<size_t>(index), std::move(value));
 				break;
@@ -147,20 +232,56 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				log_received()->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
 
 				list::set(static_cast<size_t>(index), std::move(value));
 				break;
 			}
 			case Op::REMOVE:
 			{
-				spdlog::get("logReceived")->trace(logmsg(op, version, index));
+				log_received()->trace(logmsg(op, version, index));
 
 				list::removeAt(static_cast<size_t>(index));
 				break;
 			}
+			case Op::ADD_RANGE:
+			{
+				const int32_t count = buffer.read_integral<int32_t>(encoding);
+				RD_ASSERT_THROW_MSG(count >= 0 && index <= static_cast<int64_t>(list::size()),
+					"Invalid range add to " + to_string(location) + ": index " + std::to_string(index) + ", count " +
+						std::to_string(count) + ", size " + std::to_string(list::size()));
+				std::vector<WT> values;
+				// reserve no more than the message could hold rather than what a malformed count asks for
+				values.reserve((std::min)(static_cast<size_t>(count), buffer.get_data().size() - buffer.get_position()));
+				for (int32_t i = 0; i < count; ++i)
+				{
+					values.push_back(S::read(this->get_serialization_context(), buffer));
+				}
+
+				log_received()->trace(logmsg(op, version, index) + " :: count = " + std::to_string(count));
+
+				(index < 0) ? list::addAll(std::move(values)) : list::addAll(static_cast<size_t>(index), std::move(values));
+				break;
+			}
+			case Op::REMOVE_RANGE:
+			{
+				const int32_t count = buffer.read_integral<int32_t>(encoding);
+				RD_ASSERT_THROW_MSG(index >= 0 && count >= 0 && static_cast<size_t>(index) + count <= list::size(),
+					"Invalid range remove from " + to_string(location) + ": index " + std::to_string(index) + ", count " +
+						std::to_string(count) + ", size " + std::to_string(list::size()));
+
+				log_received()->trace(logmsg(op, version, index) + " :: count = " + std::to_string(count));
+
+				list::removeRange(static_cast<size_t>(index), static_cast<size_t>(count));
+				break;
+			}
 			case Op::ACK:
 				break;
+			case Op::BATCH:
+			case Op::ACK_RANGE:
+				// map-only ops, a list never sends them
+				RD_ASSERT_THROW_MSG(false, "Unexpected " + to_string(op) + " for list " + to_string(location) + ": version " +
+											   std::to_string(version) + ", index " + std::to_string(index));
 		}
 	}
 
@@ -238,6 +359,11 @@ public:
 		return local_change([&] { return list::removeAll(std::move(elements)); });
 	}
 
+	void removeRange(size_t index, size_t count) const override
+	{
+		return local_change([&] { list::removeRange(index, count); });
+	}
+
 	friend std::string to_string(RdList const& value)
 	{
 		std::string res = "[";
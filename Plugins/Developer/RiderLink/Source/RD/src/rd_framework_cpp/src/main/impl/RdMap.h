@@ -7,6 +7,7 @@
 #include "util/shared_function.h"
 
 #include <cstdint>
+#include <map>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -24,19 +25,41 @@ namespace rd
  * \tparam VS "SerDes" for values
  * \tparam KA allocator for keys
  * \tparam VA allocator for values
+ * \tparam Storage WrapperStorage or InlineStorage, see ViewableMap
  */
 template <typename K, typename V, typename KS = Polymorphic<K>, typename VS = Polymorphic<V>, typename KA = std::allocator<K>,
-	typename VA = std::allocator<V>>
-class RdMap final : public RdReactiveBase, public ViewableMap<K, V, KA, VA>, public ISerializable
+	typename VA = std::allocator<V>, typename Storage = WrapperStorage>
+class RdMap final : public RdReactiveBase, public ViewableMap<K, V, KA, VA, Storage>, public ISerializable
 {
 private:
 	using WK = typename IViewableMap<K, V>::WK;
 	using WV = typename IViewableMap<K, V>::WV;
 	using OV = typename IViewableMap<K, V>::OV;
 
-	using map = ViewableMap<K, V>;
+	using map = ViewableMap<K, V, KA, VA, Storage>;
 	mutable int64_t next_version = 0;
-	mutable ordered_map<K const*, int64_t, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>> pendingForAck;
+	// owns its keys: key of a remove event doesn't outlive the event
+	mutable ordered_map<WK, int64_t, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>> pendingForAck;
+	// the same pending keys by their version, so that an acknowledged range is looked up rather than searched for
+	mutable std::map<int64_t, WK> pendingByVersion;
+
+	struct batch_entry
+	{
+		// whether the other side has the key from before the batch
+		bool existed;
+		// whether the key was removed inside the batch: re-adding it moves it to the end, so it's sent as Op::REMOVE and Op::ADD
+		bool removed;
+		K const* key;
+		// current value, nullptr if the key is removed
+		V const* value;
+	};
+
+	mutable int32_t batch_depth = 0;
+	// keys changed inside batch() in serialized form, in order of the first change, a re-added key moves to the end
+	mutable ordered_map<std::string, batch_entry> batch_entries;
+	mutable Buffer batch_key_buffer{size_t(0)};
+
+	using key_copyable = std::integral_constant<bool, std::is_copy_constructible<K>::value && !std::is_abstract<K>::value>;
 
 	std::string logmsg(Op op, int64_t version, K const* key, V const* value = nullptr) const
 	{
@@ -50,6 +73,240 @@ private:
 		return logmsg(op, version, key, value ? &(wrapper::get(*value)) : nullptr);
 	}
 
+	std::string range_logmsg(Op op, int64_t first_version, int64_t last_version, int32_t count) const
+	{
+		return "map " + to_string(location) + " " + to_string(rdid) + ":: " + to_string(op) + ":: count = " + std::to_string(count) +
+			   ((first_version > 0) ? " :: versions = " + std::to_string(first_version) + ".." + std::to_string(last_version) : "");
+	}
+
+	WK own_key(K const* key, Buffer::word_t const* serialized, size_t size, std::true_type) const
+	{
+		if (key)
+		{
+			return WK(*key);
+		}
+		return own_key(key, serialized, size, std::false_type{});
+	}
+
+	WK own_key(K const* /*key*/, Buffer::word_t const* serialized, size_t size, std::false_type) const
+	{
+		Buffer buffer(Buffer::ByteArray(serialized, serialized + size));
+		return KS::read(this->get_serialization_context(), buffer);
+	}
+
+	/**
+	 * \brief Remembers [version] as the last one sent for the key until the other side acknowledges it.
+	 * \param key the key if it's still alive, otherwise the key is restored from its [serialized] form
+	 */
+	void expect_ack(K const* key, Buffer::word_t const* serialized, size_t size, int64_t version) const
+	{
+		WK owned = own_key(key, serialized, size, key_copyable{});
+		auto it = pendingForAck.find(owned);
+		if (it != pendingForAck.end())
+		{
+			// an acknowledgement of the previous version doesn't clear the key anymore
+			pendingByVersion.erase(it->second);
+			it.value() = version;
+		}
+		else
+		{
+			pendingForAck.emplace(owned, version);
+		}
+		pendingByVersion.emplace(version, std::move(owned));
+	}
+
+	std::string ack_error(Op op, bool msg_versioned) const
+	{
+		if (!msg_versioned)
+		{
+			return "Received " + to_string(op) + " while msg hasn't versioned flag set";
+		}
+		if (!is_master)
+		{
+			return "Received " + to_string(op) + " when not a Master";
+		}
+		return "";
+	}
+
+	void add_to_batch(typename IViewableMap<K, V>::Event const& e) const
+	{
+		batch_key_buffer.rewind();
+		KS::write(this->get_serialization_context(), batch_key_buffer, *e.get_key());
+		std::string serialized(reinterpret_cast<char const*>(batch_key_buffer.data()), batch_key_buffer.get_position());
+
+		const Op op = static_cast<Op>(e.v.index());
+		auto it = batch_entries.find(serialized);
+		if (it == batch_entries.end())
+		{
+			const bool existed = op != Op::ADD;
+			batch_entries.emplace(std::move(serialized), batch_entry{existed, op == Op::REMOVE, e.get_key(), e.get_new_value()});
+		}
+		else if (op == Op::ADD)
+		{
+			// the key was removed earlier in the batch, re-adding puts it after the keys changed so far as in this map
+			const batch_entry removed{it.value().existed, true, e.get_key(), e.get_new_value()};
+			batch_entries.erase(it);
+			batch_entries.emplace(std::move(serialized), removed);
+		}
+		else
+		{
+			it.value().removed = it.value().removed || op == Op::REMOVE;
+			it.value().key = e.get_key();
+			it.value().value = e.get_new_value();
+		}
+	}
+
+	void end_batch() const
+	{
+		if (--batch_depth > 0 || batch_entries.empty())
+			return;
+
+		const auto entries = std::move(batch_entries);
+		batch_entries.clear();
+
+		int32_t count = 0;
+		size_t size = 0;
+		for (auto const& entry : entries)
+		{
+			batch_entry const& change = entry.second;
+			if (change.existed && (change.removed || !change.value))
+			{
+				++count;
+				size += sizeof(int32_t) + entry.first.size();
+			}
+			if (change.value)
+			{
+				++count;
+				size += sizeof(int32_t) + entry.first.size() + serialized_size_of<VS>(this->get_serialization_context(), *change.value);
+			}
+		}
+		if (count == 0)
+			return;
+
+		get_wire()->send_inline(rdid, [&](Buffer& buffer) {
+			const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+			int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
+
+			buffer.write_integral<int32_t>(static_cast<int32_t>(Op::BATCH) | versionedFlag, encoding);
+
+			const int64_t first_version = is_master ? next_version + 1 : 0L;
+			if (is_master)
+			{
+				buffer.write_integral<int64_t>(first_version, encoding);
+			}
+			buffer.write_integral<int32_t>(count, encoding);
+			buffer.require_available(size);
+
+			for (auto const& entry : entries)
+			{
+				batch_entry const& change = entry.second;
+				auto serialized_key = reinterpret_cast<Buffer::word_t const*>(entry.first.data());
+
+				if (change.existed && (change.removed || !change.value))
+				{
+					buffer.write_integral<int32_t>(static_cast<int32_t>(Op::REMOVE), encoding);
+					buffer.write_raw(serialized_key, entry.first.size());
+					if (is_master)
+					{
+						expect_ack(nullptr, serialized_key, entry.first.size(), ++next_version);
+					}
+				}
+
+				if (change.value)
+				{
+					const Op op = (change.existed && !change.removed) ? Op::UPDATE : Op::ADD;
+					buffer.write_integral<int32_t>(static_cast<int32_t>(op), encoding);
+					buffer.write_raw(serialized_key, entry.first.size());
+					if (is_master)
+					{
+						expect_ack(change.key, serialized_key, entry.first.size(), ++next_version);
+					}
+					VS::write(this->get_serialization_context(), buffer, *change.value);
+				}
+			}
+
+			log_send()->trace("SEND{}", range_logmsg(Op::BATCH, first_version, next_version, count));
+		});
+	}
+
+	void apply_remote(Op op, int64_t version, bool msg_versioned, WK key, optional<WV> value) const
+	{
+		if (msg_versioned || !is_master || pendingForAck.count(key) == 0)
+		{
+			log_received()->trace("RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
+			if (value.has_value())
+			{
+				map::set(std::move(key), *std::move(value));
+			}
+			else
+			{
+				map::remove(wrapper::get<K>(key));
+			}
+		}
+		else
+		{
+			log_received()->trace("{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
+		}
+	}
+
+	void receive_batch(Buffer& buffer, bool msg_versioned) const
+	{
+		const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+		const int64_t first_version = msg_versioned ? buffer.read_integral<int64_t>(encoding) : 0;
+		const int32_t count = buffer.read_integral<int32_t>(encoding);
+
+		for (int32_t i = 0; i < count; ++i)
+		{
+			const Op op = static_cast<Op>(buffer.read_integral<int32_t>(encoding));
+			WK key = KS::read(this->get_serialization_context(), buffer);
+			optional<WV> value;
+			if (op == Op::ADD || op == Op::UPDATE)
+			{
+				value = VS::read(this->get_serialization_context(), buffer);
+			}
+			apply_remote(op, msg_versioned ? first_version + i : 0, msg_versioned, std::move(key), std::move(value));
+		}
+
+		if (msg_versioned && count > 0)
+		{
+			// one acknowledgement for the whole version range of the batch
+			get_wire()->send_inline(rdid, [&](Buffer& innerBuffer) {
+				innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK_RANGE), encoding);
+				innerBuffer.write_integral<int64_t>(first_version, encoding);
+				innerBuffer.write_integral<int64_t>(first_version + count - 1, encoding);
+			});
+			if (is_master)
+			{
+				log_received()->error("Both ends are masters: {}", to_string(location));
+			}
+		}
+	}
+
+	void receive_ack_range(Buffer& buffer, bool msg_versioned) const
+	{
+		const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+		const int64_t first_version = buffer.read_integral<int64_t>(encoding);
+		const int64_t last_version = buffer.read_integral<int64_t>(encoding);
+		const int32_t count = static_cast<int32_t>(last_version - first_version + 1);
+
+		const std::string errmsg = ack_error(Op::ACK_RANGE, msg_versioned);
+		if (!errmsg.empty())
+		{
+			log_received()->error(range_logmsg(Op::ACK_RANGE, first_version, last_version, count) + " >> " + errmsg);
+			return;
+		}
+
+		// only the latest version of a key is indexed, keys changed again after the batch stay pending
+		const auto first = pendingByVersion.lower_bound(first_version);
+		const auto last = pendingByVersion.upper_bound(last_version);
+		for (auto it = first; it != last; ++it)
+		{
+			pendingForAck.unordered_erase(it->second);
+		}
+		pendingByVersion.erase(first, last);
+		log_received()->trace(range_logmsg(Op::ACK_RANGE, first_version, last_version, count));
+	}
+
 public:
 	bool is_master = false;
 
@@ -71,9 +328,9 @@ public:
 	virtual ~RdMap() = default;
 	// endregion
 
-	static RdMap<K, V, KS, VS> read(SerializationCtx& /*ctx*/, Buffer& buffer)
+	static RdMap read(SerializationCtx& /*ctx*/, Buffer& buffer)
 	{
-		RdMap<K, V, KS, VS> res;
+		RdMap res;
 		RdId id = RdId::read(buffer);
 		withId(res, id);
 		return res;
@@ -86,11 +343,44 @@ public:
 
 	static const int32_t versionedFlagShift = 8;
 
+	/**
+	 * \brief Runs [action] as one transaction: changes made inside it are sent to the other side in a single Op::BATCH
+	 * message when [action] returns, a key changed several times is sent in its final state only. A master gets
+	 * the whole batch acknowledged by one Op::ACK_RANGE. Nested calls join the outer batch.
+	 * The other side must understand Op::BATCH.
+	 */
+	template <typename F>
+	void batch(F&& action) const
+	{
+		++batch_depth;
+		try
+		{
+			action();
+		}
+		catch (...)
+		{
+			end_batch();
+			throw;
+		}
+		end_batch();
+	}
+
+	/**
+	 * \brief Send the current entries as one Op::BATCH message on bind instead of one message per entry.
+	 * The other side must understand Op::BATCH.
+	 */
+	bool snapshot_on_bind = false;
+
 	void init(Lifetime lifetime) const override
 	{
 		RdBindableBase::init(lifetime);
 
 		local_change([this, lifetime]() {
+			if (snapshot_on_bind)
+			{
+				// advise replays current entries, collect them into a batch
+				++batch_depth;
+			}
 			advise(lifetime, [this, lifetime](Event e) {
 				if (!is_local_change)
 					return;
@@ -103,31 +393,50 @@ public:
 					identifyPolymorphic(*new_value, *identity, identity->next(rdid));
 				}
 
-				get_wire()->send(rdid, [this, e](Buffer& buffer) {
+				if (batch_depth > 0)
+				{
+					add_to_batch(e);
+					return;
+				}
+
+				get_wire()->send_inline(rdid, [this, e](Buffer& buffer) {
+					const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
 					int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
 					Op op = static_cast<Op>(e.v.index());
 
-					buffer.write_integral<int32_t>(static_cast<int32_t>(op) | versionedFlag);
+					buffer.write_integral<int32_t>(static_cast<int32_t>(op) | versionedFlag, encoding);
 
 					int64_t version = is_master ? ++next_version : 0L;
 
 					if (is_master)
 					{
-						pendingForAck.emplace(e.get_key(), version);
-						buffer.write_integral(version);
+						buffer.write_integral<int64_t>(version, encoding);
 					}
 
+					V const* new_value = e.get_new_value();
+					buffer.require_available(serialized_size_of<KS>(this->get_serialization_context(), *e.get_key()) +
+											 (new_value ? serialized_size_of<VS>(this->get_serialization_context(), *new_value) : 0));
+
+					const size_t key_start = buffer.get_position();
 					KS::write(this->get_serialization_context(), buffer, *e.get_key());
 
-					V const* new_value = e.get_new_value();
+					if (is_master)
+					{
+						expect_ack(e.get_key(), buffer.data() + key_start, buffer.get_position() - key_start, version);
+					}
+
 					if (new_value)
 					{
 						VS::write(this->get_serialization_context(), buffer, *new_value);
 					}
 
-					spdlog::get("logSend")->trace("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
+					log_send()->trace("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
 				});
 			});
+			if (snapshot_on_bind)
+			{
+				end_batch();
+			}
 		});
 
 		get_wire()->advise(lifetime, this);
@@ -140,26 +449,32 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int32_t header = buffer.read_integral<int32_t>();
+		const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+		int32_t header = buffer.read_integral<int32_t>(encoding);
 		bool msg_versioned = (header >> versionedFlagShift) != 0;
 		Op op = static_cast<Op>(header & ((1 << versionedFlagShift) - 1));
 
-		int64_t version = msg_versioned ? buffer.read_integral<int64_t>() : 0;
+		if (op == Op::BATCH)
+		{
+			receive_batch(buffer, msg_versioned);
+			return;
+		}
+		if (op == Op::ACK_RANGE)
+		{
+			receive_ack_range(buffer, msg_versioned);
+			return;
+		}
 
+		int64_t version = msg_versioned ? buffer.read_integral<int64_t>(encoding) : 0;
+
+		const size_t key_start = buffer.get_position();
 		WK key = KS::read(this->get_serialization_context(), buffer);
+		const size_t key_size = buffer.get_position() - key_start;
 
 		if (op == Op::ACK)
 		{
-			std::string errmsg;
-			if (!msg_versioned)
-			{
-				errmsg = "Received " + to_string(Op::ACK) + " while msg hasn't versioned flag set";
-			}
-			else if (!is_master)
-			{
-				errmsg = "Received " + to_string(Op::ACK) + " when not a Master";
-			}
-			else
+			std::string errmsg = ack_error(Op::ACK, msg_versioned);
+			if (errmsg.empty())
 			{
 				if (pendingForAck.count(key) > 0)
 				{
@@ -174,7 +489,8 @@ public:
 						// side effect
 						if (pendingVersion == version)
 						{
-							pendingForAck.erase(key);	 // else we don't need to remove, silently drop
+							pendingForAck.unordered_erase(key);	   // else we don't need to remove, silently drop
+							pendingByVersion.erase(version);
 						}
 						// return good result
 					}
@@ -186,18 +502,15 @@ public:
 			}
 			if (errmsg.empty())
 			{
-				spdlog::get("logReceived")->trace(logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
+				log_received()->trace(logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
 			}
 			else
 			{
-				spdlog::get("logReceived")->error(logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
+				log_received()->error(logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
 			}
 		}
 		else
 		{
-			Buffer serialized_key;
-			KS::write(this->get_serialization_context(), serialized_key, wrapper::get<K>(key));
-
 			bool is_put = (op == Op::ADD || op == Op::UPDATE);
 			optional<WV> value;
 			if (is_put)
@@ -205,37 +518,19 @@ public:
 				value = VS::read(this->get_serialization_context(), buffer);
 			}
 
-			if (msg_versioned || !is_master || pendingForAck.count(key) == 0)
-			{
-				spdlog::get("logReceived")->trace("RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
-				if (value.has_value())
-				{
-					map::set(std::move(key), *std::move(value));
-				}
-				else
-				{
-					map::remove(wrapper::get<K>(key));
-				}
-			}
-			else
-			{
-				spdlog::get("logReceived")->trace("{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
-			}
+			apply_remote(op, version, msg_versioned, std::move(key), std::move(value));
 
 			if (msg_versioned)
 			{
-				auto writer =
-					util::make_shared_function([version, serialized_key = std::move(serialized_key)](Buffer& innerBuffer) mutable {
-						innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
-						innerBuffer.write_integral<int64_t>(version);
-						// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
-						innerBuffer.write_byte_array_raw(serialized_key.getArray());
-						// logSend.trace(logmsg(Op::ACK, version, serialized_key));
-					});
-				get_wire()->send(rdid, std::move(writer));
+				get_wire()->send_inline(rdid, [&](Buffer& innerBuffer) {
+					innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK), encoding);
+					innerBuffer.write_integral<int64_t>(version, encoding);
+					// echo the key exactly as received
+					innerBuffer.write_raw(buffer.data() + key_start, key_size);
+				});
 				if (is_master)
 				{
-					spdlog::get("logReceived")->error("Both ends are masters: {}", to_string(location));
+					log_received()->error("Both ends are masters: {}", to_string(location));
 				}
 			}
 		}
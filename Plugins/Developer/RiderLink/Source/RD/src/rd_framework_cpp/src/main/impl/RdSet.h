@@ -18,15 +18,43 @@ namespace rd
  *
  * \tparam T type of stored values
  * \tparam S "SerDes" for values
+ * \tparam Storage WrapperStorage or InlineStorage, see ViewableSet
  */
-template <typename T, typename S = Polymorphic<T>, typename A = allocator<T>>
-class RdSet final : public RdReactiveBase, public ViewableSet<T, A>, public ISerializable
+template <typename T, typename S = Polymorphic<T>, typename A = allocator<T>, typename Storage = WrapperStorage>
+class RdSet final : public RdReactiveBase, public ViewableSet<T, A, Storage>, public ISerializable
 {
 private:
 	using WT = typename IViewableSet<T>::WT;
 
+	// wire-only kind following AddRemove values: all elements of the set in one message
+	static const int32_t snapshotKind = 2;
+
+	mutable bool skip_replay = false;
+
+	void send_snapshot() const
+	{
+		get_wire()->send_inline(rdid, [this](Buffer& buffer) {
+			const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+			buffer.write_integral<int32_t>(static_cast<int32_t>(snapshotKind), encoding);
+			buffer.write_integral<int32_t>(static_cast<int32_t>(set::size()), encoding);
+
+			size_t size = 0;
+			for (T const& v : *this)
+			{
+				size += serialized_size_of<S>(this->get_serialization_context(), v);
+			}
+			buffer.require_available(size);
+			for (T const& v : *this)
+			{
+				S::write(this->get_serialization_context(), buffer, v);
+			}
+
+			log_send()->trace("SENDset {} {}:: snapshot:: count = {}", to_string(location), to_string(rdid), set::size());
+		});
+	}
+
 protected:
-	using set = ViewableSet<T>;
+	using set = ViewableSet<T, A, Storage>;
 
 public:
 	using Event = typename IViewableSet<T>::Event;
@@ -45,9 +73,9 @@ public:
 
 	// endregion
 
-	static RdSet<T, S> read(SerializationCtx& /*ctx*/, Buffer& buffer)
+	static RdSet read(SerializationCtx& /*ctx*/, Buffer& buffer)
 	{
-		RdSet<T, S> result;
+		RdSet result;
 		RdId id = RdId::read(buffer);
 		withId(result, std::move(id));
 		return result;
@@ -60,22 +88,36 @@ public:
 
 	bool optimize_nested = false;
 
+	/**
+	 * \brief Send the current elements as one snapshot message on bind instead of one message per element.
+	 * Both sides must enable it.
+	 */
+	bool snapshot_on_bind = false;
+
 	void init(Lifetime lifetime) const override
 	{
 		RdBindableBase::init(lifetime);
 
 		local_change([this, lifetime] {
+			if (snapshot_on_bind && !set::empty())
+			{
+				send_snapshot();
+				// advise below replays the elements already sent
+				skip_replay = true;
+			}
 			advise(lifetime, [this](AddRemove kind, T const& v) {
-				if (!is_local_change)
+				if (!is_local_change || skip_replay)
 					return;
 
-				get_wire()->send(rdid, [this, kind, &v](Buffer& buffer) {
-					buffer.write_enum<AddRemove>(kind);
+				get_wire()->send_inline(rdid, [this, kind, &v](Buffer& buffer) {
+					buffer.write_integral<int32_t>(static_cast<int32_t>(kind), this->get_serialization_context().get_integer_encoding());
+					buffer.require_available(serialized_size_of<S>(this->get_serialization_context(), v));
 					S::write(this->get_serialization_context(), buffer, v);
 
-					spdlog::get("logSend")->trace("SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
+					log_send()->trace("SENDset {} {}:: {}:: {}", to_string(location), to_string(rdid), to_string(kind), to_string(v));
 				});
 			});
+			skip_replay = false;
 		});
 
 		get_wire()->advise(lifetime, this);
@@ -83,7 +125,25 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		AddRemove kind = buffer.read_enum<AddRemove>();
+		const IntegerEncoding encoding = this->get_serialization_context().get_integer_encoding();
+		const int32_t header = buffer.read_integral<int32_t>(encoding);
+		if (header == snapshotKind)
+		{
+			const int32_t count = buffer.read_integral<int32_t>(encoding);
+			RD_ASSERT_THROW_MSG(count >= 0, "Invalid snapshot for set " + to_string(location) + ": count " + std::to_string(count));
+			std::vector<WT> elements;
+			// reserve no more than the message could hold rather than what a malformed count asks for
+			elements.reserve((std::min)(static_cast<size_t>(count), buffer.get_data().size() - buffer.get_position()));
+			for (int32_t i = 0; i < count; ++i)
+			{
+				elements.push_back(S::read(this->get_serialization_context(), buffer));
+			}
+
+			set::addAll(std::move(elements));
+			return;
+		}
+
+		AddRemove kind = static_cast<AddRemove>(header);
 		auto value = S::read(this->get_serialization_context(), buffer);
 
 		switch (kind)
@@ -82,7 +82,7 @@ public:
 	void on_wire_received(Buffer buffer) const override
 	{
 		auto value = S::read(this->get_serialization_context(), buffer);
-		spdlog::get("logReceived")->trace("RECV{}", logmsg(wrapper::get<T>(value)));
+		log_received()->trace("RECV{}", logmsg(wrapper::get<T>(value)));
 
 		signal.fire(wrapper::get<T>(value));
 	}
@@ -102,8 +102,9 @@ public:
 
 		if (async && !is_bound()) return;
 
-		get_wire()->send(rdid, [this, &value](Buffer& buffer) {
-			spdlog::get("logSend")->trace("SEND{}", logmsg(value));
+		get_wire()->send_inline(rdid, [this, &value](Buffer& buffer) {
+			log_send()->trace("SEND{}", logmsg(value));
+			buffer.require_available(serialized_size_of<S>(get_serialization_context(), value));
 			S::write(get_serialization_context(), buffer, value);
 		});
 		signal.fire(value);
@@ -2,6 +2,7 @@
 
 #include "serialization/AbstractPolymorphic.h"
 #include "serialization/InternedAnySerializer.h"
+#include "util/Metrics.h"
 
 namespace rd
 {
@@ -49,6 +50,12 @@ void InternRoot::bind(Lifetime lf, IRdDynamic const* parent, string_view name) c
 		other_items_list.clear();
 		inverse_map.clear();
 	}
+	util::MetricsRegistry::instance().add_source(lf, [this](util::MetricsSnapshot& snapshot) {
+		const std::string prefix = "intern_root." + to_string(location) + ".";
+		std::lock_guard<decltype(lock)> guard(lock);
+		snapshot.add(prefix + "own_items", static_cast<double>(my_items_lis.size()));
+		snapshot.add(prefix + "other_items", static_cast<double>(other_items_list.size()));
+	});
 	get_protocol()->get_wire()->advise(lf, this);
 }
 
@@ -110,7 +110,7 @@ int32_t InternRoot::intern_value(Wrapper<T> value) const
 	int32_t index = 0;
 	if (it == inverse_map.end())
 	{
-		get_protocol()->get_wire()->send(this->rdid, [this, &index, value, any](Buffer& buffer) {
+		get_protocol()->get_wire()->send_inline(this->rdid, [this, &index, value, any](Buffer& buffer) {
 			InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
 			{
 				std::lock_guard<decltype(lock)> guard(lock);
@@ -4,9 +4,222 @@
 
 #include <string>
 #include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RD_BUFFER_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RD_BUFFER_NEON
+#include <arm_neon.h>
+#endif
 
 namespace rd
 {
+namespace
+{
+// region utf16
+
+// Wire strings are UTF-16 code units, native std::wstring is UTF-32 where wchar_t is 4 bytes.
+// Well-formed surrogate pairs are combined into one code point, unpaired surrogates are kept as separate
+// code points so that any wire string survives read/write unchanged.
+
+constexpr size_t UTF16_BLOCK = 8;
+
+inline uint16_t load_unit(Buffer::word_t const* src, size_t i)
+{
+	uint16_t unit;
+	std::memcpy(&unit, src + i * sizeof(uint16_t), sizeof(uint16_t));
+	return unit;
+}
+
+inline void store_unit(Buffer::word_t* dst, size_t i, uint16_t unit)
+{
+	std::memcpy(dst + i * sizeof(uint16_t), &unit, sizeof(uint16_t));
+}
+
+inline bool is_high_surrogate(uint32_t unit)
+{
+	return (unit & 0xFC00u) == 0xD800u;
+}
+
+inline bool is_low_surrogate(uint32_t unit)
+{
+	return (unit & 0xFC00u) == 0xDC00u;
+}
+
+/**
+ * \brief Widens [UTF16_BLOCK] code units at [src] into [dst] if none of them is a surrogate.
+ * \return false if block must be decoded by scalar path
+ */
+inline bool widen_block(Buffer::word_t const* src, uint32_t* dst)
+{
+#if defined(RD_BUFFER_SSE2)
+	const __m128i units = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+	const __m128i surrogates = _mm_cmpeq_epi16(
+		_mm_and_si128(units, _mm_set1_epi16(static_cast<int16_t>(0xF800))), _mm_set1_epi16(static_cast<int16_t>(0xD800)));
+	if (_mm_movemask_epi8(surrogates) != 0)
+	{
+		return false;
+	}
+	const __m128i zero = _mm_setzero_si128();
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(units, zero));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(units, zero));
+	return true;
+#elif defined(RD_BUFFER_NEON)
+	const uint16x8_t units = vreinterpretq_u16_u8(vld1q_u8(src));
+	const uint16x8_t surrogates = vceqq_u16(vandq_u16(units, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800));
+	if (vmaxvq_u16(surrogates) != 0)
+	{
+		return false;
+	}
+	vst1q_u32(dst, vmovl_u16(vget_low_u16(units)));
+	vst1q_u32(dst + 4, vmovl_u16(vget_high_u16(units)));
+	return true;
+#else
+	for (size_t i = 0; i < UTF16_BLOCK; ++i)
+	{
+		const uint16_t unit = load_unit(src, i);
+		if ((unit & 0xF800u) == 0xD800u)
+		{
+			return false;
+		}
+		dst[i] = unit;
+	}
+	return true;
+#endif
+}
+
+/**
+ * \brief Narrows [UTF16_BLOCK] code points at [src] into [dst] if all of them are in BMP.
+ * \return false if block must be encoded by scalar path
+ */
+inline bool narrow_block(uint32_t const* src, Buffer::word_t* dst)
+{
+#if defined(RD_BUFFER_SSE2)
+	const __m128i lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+	const __m128i hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4));
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i in_bmp = _mm_and_si128(
+		_mm_cmpeq_epi32(_mm_srli_epi32(lo, 16), zero), _mm_cmpeq_epi32(_mm_srli_epi32(hi, 16), zero));
+	if (_mm_movemask_epi8(in_bmp) != 0xFFFF)
+	{
+		return false;
+	}
+	// SSE2 has only signed saturation, so shift the range to int16 and back
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(lo, bias32), _mm_sub_epi32(hi, bias32));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_add_epi16(packed, _mm_set1_epi16(static_cast<int16_t>(0x8000))));
+	return true;
+#elif defined(RD_BUFFER_NEON)
+	const uint32x4_t lo = vld1q_u32(src);
+	const uint32x4_t hi = vld1q_u32(src + 4);
+	if (vmaxvq_u32(vorrq_u32(lo, hi)) > 0xFFFFu)
+	{
+		return false;
+	}
+	vst1q_u8(dst, vreinterpretq_u8_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi))));
+	return true;
+#else
+	for (size_t i = 0; i < UTF16_BLOCK; ++i)
+	{
+		if (src[i] > 0xFFFFu)
+		{
+			return false;
+		}
+	}
+	for (size_t i = 0; i < UTF16_BLOCK; ++i)
+	{
+		store_unit(dst, i, static_cast<uint16_t>(src[i]));
+	}
+	return true;
+#endif
+}
+
+/**
+ * \brief Decodes [len] UTF-16 code units at [src] into [dst], which must have room for [len] code points.
+ * \return number of code points written
+ */
+size_t utf16_to_utf32(Buffer::word_t const* src, size_t len, uint32_t* dst)
+{
+	size_t i = 0;
+	size_t j = 0;
+	while (i < len)
+	{
+		if (i + UTF16_BLOCK <= len && widen_block(src + i * sizeof(uint16_t), dst + j))
+		{
+			i += UTF16_BLOCK;
+			j += UTF16_BLOCK;
+			continue;
+		}
+		const size_t block_end = (std::min)(i + UTF16_BLOCK, len);
+		while (i < block_end)
+		{
+			uint32_t code_point = load_unit(src, i++);
+			if (is_high_surrogate(code_point) && i < len)
+			{
+				const uint32_t next = load_unit(src, i);
+				if (is_low_surrogate(next))
+				{
+					code_point = 0x10000u + ((code_point - 0xD800u) << 10) + (next - 0xDC00u);
+					++i;
+				}
+			}
+			dst[j++] = code_point;
+		}
+	}
+	return j;
+}
+
+/**
+ * \return number of UTF-16 code units required to encode [len] code points at [src]
+ */
+size_t utf16_length(uint32_t const* src, size_t len)
+{
+	size_t result = len;
+	for (size_t i = 0; i < len; ++i)
+	{
+		result += src[i] > 0xFFFFu ? 1 : 0;
+	}
+	return result;
+}
+
+/**
+ * \brief Encodes [len] code points at [src] into UTF-16 [dst], which must have room for utf16_length(src, len) units.
+ */
+void utf32_to_utf16(uint32_t const* src, size_t len, Buffer::word_t* dst)
+{
+	size_t i = 0;
+	size_t j = 0;
+	while (i < len)
+	{
+		if (i + UTF16_BLOCK <= len && narrow_block(src + i, dst + j * sizeof(uint16_t)))
+		{
+			i += UTF16_BLOCK;
+			j += UTF16_BLOCK;
+			continue;
+		}
+		const size_t block_end = (std::min)(i + UTF16_BLOCK, len);
+		for (; i < block_end; ++i)
+		{
+			const uint32_t code_point = src[i];
+			if (code_point > 0xFFFFu)
+			{
+				RD_ASSERT_MSG(code_point <= 0x10FFFFu, "Code point " + std::to_string(code_point) + " is out of Unicode range");
+				const uint32_t offset = code_point - 0x10000u;
+				store_unit(dst, j++, static_cast<uint16_t>(0xD800u + ((offset >> 10) & 0x3FFu)));
+				store_unit(dst, j++, static_cast<uint16_t>(0xDC00u + (offset & 0x3FFu)));
+			}
+			else
+			{
+				store_unit(dst, j++, static_cast<uint16_t>(code_point));
+			}
+		}
+	}
+}
+// endregion
+}	 // namespace
+
 Buffer::Buffer() : Buffer(16)
 {
 }
@@ -58,7 +271,7 @@ void Buffer::write(const word_t* src, size_t size)
 
 void Buffer::require_available(size_t moreSize)
 {
-	if (offset + moreSize >= size())
+	if (offset + moreSize > size())
 	{
 		const size_t new_size = (std::max)(size() * 2, offset + moreSize);
 		data_.resize(new_size);
@@ -138,6 +351,20 @@ std::wstring read_wstring_spec(Buffer& buffer)
 	return std::wstring(v.begin(), v.end());
 }
 
+template <>
+std::wstring read_wstring_spec<4>(Buffer& buffer)
+{
+	const int32_t len = buffer.read_integral<int32_t>();
+	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
+	buffer.check_available(sizeof(uint16_t) * len);
+	std::wstring result;
+	result.resize(len);
+	const size_t decoded = utf16_to_utf32(buffer.current_pointer(), len, reinterpret_cast<uint32_t*>(&result[0]));
+	result.resize(decoded);
+	buffer.offset += sizeof(uint16_t) * len;
+	return result;
+}
+
 template <>
 std::wstring read_wstring_spec<2>(Buffer& buffer)
 {
@@ -161,6 +388,17 @@ void write_wstring_spec(Buffer& buffer, wstring_view value)
 	buffer.write_array<std::vector, uint16_t>(v);
 }
 
+template <>
+void write_wstring_spec<4>(Buffer& buffer, wstring_view value)
+{
+	auto const* code_points = reinterpret_cast<uint32_t const*>(value.data());
+	const size_t len = utf16_length(code_points, value.size());
+	buffer.write_integral<int32_t>(static_cast<int32_t>(len));
+	buffer.require_available(sizeof(uint16_t) * len);
+	utf32_to_utf16(code_points, value.size(), buffer.current_pointer());
+	buffer.offset += sizeof(uint16_t) * len;
+}
+
 template <>
 void write_wstring_spec<2>(Buffer& buffer, wstring_view value)
 {
@@ -199,6 +437,14 @@ void Buffer::write_wstring(Wrapper<std::wstring> const& value)
 	write_wstring(*value);
 }
 
+size_t Buffer::wstring_size(wstring_view value)
+{
+	const size_t units = sizeof(wchar_t) == sizeof(uint16_t)
+							 ? value.size()
+							 : utf16_length(reinterpret_cast<uint32_t const*>(value.data()), value.size());
+	return sizeof(int32_t) + sizeof(uint16_t) * units;
+}
+
 int64_t TICKS_AT_EPOCH = 621355968000000000L;
 int64_t TICKS_PER_MILLISECOND = 10000000;
 
@@ -254,6 +500,11 @@ void Buffer::write_byte_array_raw(const ByteArray& array)
 	write(array.data(), array.size());
 }
 
+void Buffer::write_raw(const word_t* src, size_t size)
+{
+	write(src, size);
+}
+
 Buffer::ByteArray& Buffer::get_data()
 {
 	return data_;
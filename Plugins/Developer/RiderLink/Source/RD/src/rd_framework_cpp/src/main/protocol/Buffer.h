@@ -21,6 +21,17 @@
 
 namespace rd
 {
+/**
+ * \brief Wire representation of integral values.
+ * [Fixed] writes the full sizeof(T) bytes, [Compact] writes LEB128 varint (zigzag-mapped for signed types).
+ * Both sides of a protocol must agree on the encoding.
+ */
+enum class IntegerEncoding : uint8_t
+{
+	Fixed,
+	Compact
+};
+
 /**
  * \brief Simple data buffer. Allows to "SerDes" plenty of types, such as integrals, arrays, etc.
  */
@@ -54,6 +65,21 @@ private:
 
 	size_t size() const;
 
+	template <typename T, typename U = std::make_unsigned_t<T>>
+	static U zigzag_encode(T value)
+	{
+		return std::is_signed<T>::value
+				   ? static_cast<U>(static_cast<U>(static_cast<U>(value) << 1) ^ static_cast<U>(value >> (sizeof(T) * 8 - 1)))
+				   : static_cast<U>(value);
+	}
+
+	template <typename T, typename U = std::make_unsigned_t<T>>
+	static T zigzag_decode(U value)
+	{
+		return std::is_signed<T>::value ? static_cast<T>(static_cast<U>(value >> 1) ^ static_cast<U>(0u - (value & 1u)))
+										: static_cast<T>(value);
+	}
+
 public:
 	// region ctor/dtor
 
@@ -97,6 +123,109 @@ public:
 		write(reinterpret_cast<word_t const*>(&value), sizeof(T));
 	}
 
+	/**
+	 * \brief Reads LEB128 varint, zigzag-decoded if [T] is signed.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
+	T read_varint()
+	{
+		using U = std::make_unsigned_t<T>;
+		U result = 0;
+		for (size_t shift = 0;; shift += 7)
+		{
+			RD_ASSERT_THROW_MSG(shift < sizeof(U) * 8, "Malformed varint at position " + std::to_string(offset));
+			check_available(1);
+			const word_t byte = data_[offset++];
+			result |= static_cast<U>(static_cast<U>(byte & 0x7Fu) << shift);
+			if ((byte & 0x80u) == 0)
+			{
+				break;
+			}
+		}
+		return zigzag_decode<T>(result);
+	}
+
+	/**
+	 * \brief Writes LEB128 varint, zigzag-encoded if [T] is signed. Takes from 1 to (sizeof(T) * 8 + 6) / 7 bytes.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	void write_varint(T const& value)
+	{
+		auto rest = zigzag_encode(value);
+		word_t bytes[(sizeof(T) * 8 + 6) / 7];
+		size_t count = 0;
+		while (rest >= 0x80u)
+		{
+			bytes[count++] = static_cast<word_t>(rest | 0x80u);
+			rest = static_cast<decltype(rest)>(rest >> 7);
+		}
+		bytes[count++] = static_cast<word_t>(rest);
+		write(bytes, count);
+	}
+
+	/**
+	 * \return number of bytes \ref write_varint takes for [value]
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	static size_t varint_size(T const& value)
+	{
+		auto rest = zigzag_encode(value);
+		size_t count = 1;
+		while (rest >= 0x80u)
+		{
+			rest = static_cast<decltype(rest)>(rest >> 7);
+			++count;
+		}
+		return count;
+	}
+
+	/**
+	 * \return number of bytes \ref write_integral takes for [value] in given [encoding]
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	static size_t integral_size(T const& value, IntegerEncoding encoding)
+	{
+		return encoding == IntegerEncoding::Compact ? varint_size(value) : sizeof(T);
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
+	T read_integral(IntegerEncoding encoding)
+	{
+		return encoding == IntegerEncoding::Compact ? read_varint<T>() : read_integral<T>();
+	}
+
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	void write_integral(T const& value, IntegerEncoding encoding)
+	{
+		if (encoding == IntegerEncoding::Compact)
+		{
+			write_varint<T>(value);
+		}
+		else
+		{
+			write_integral<T>(value);
+		}
+	}
+
+	/**
+	 * \brief Reads object representation of trivially serializable struct [T].
+	 */
+	template <typename T, typename = typename std::enable_if_t<util::is_trivially_serializable_v<T>, T>>
+	T read_trivial()
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Trivially serializable type must be trivially copyable");
+		T result;
+		read(reinterpret_cast<word_t*>(&result), sizeof(T));
+		return result;
+	}
+
+	template <typename T, typename = typename std::enable_if_t<util::is_trivially_serializable_v<T>>>
+	void write_trivial(T const& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Trivially serializable type must be trivially copyable");
+		write(reinterpret_cast<word_t const*>(&value), sizeof(T));
+	}
+
 	template <typename T, typename = typename std::enable_if_t<std::is_floating_point<T>::value, T>>
 	T read_floating_point()
 	{
@@ -112,10 +241,10 @@ public:
 	}
 
 	template <template <class, class> class C, typename T, typename A = allocator<T>,
-		typename = typename std::enable_if_t<util::is_pod_v<T>>>
-	C<T, A> read_array()
+		typename = typename std::enable_if_t<util::is_pod_v<T> || util::is_trivially_serializable_v<T>>>
+	C<T, A> read_array(IntegerEncoding length_encoding = IntegerEncoding::Fixed)
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_integral<int32_t>(length_encoding);
 		RD_ASSERT_MSG(len >= 0, "read null array(length = " + std::to_string(len) + ")");
 		C<T, A> result;
 		using rd::resize;
@@ -127,10 +256,11 @@ public:
 		return result;
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>>
-	C<value_or_wrapper<T>, A> read_array(std::function<value_or_wrapper<T>()> reader)
+	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>, typename F,
+		typename = typename std::enable_if_t<!util::is_same_v<std::decay_t<F>, IntegerEncoding>>>
+	C<value_or_wrapper<T>, A> read_array(F&& reader, IntegerEncoding length_encoding = IntegerEncoding::Fixed)
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_integral<int32_t>(length_encoding);
 		C<value_or_wrapper<T>, A> result;
 		using rd::resize;
 		resize(result, len);
@@ -142,35 +272,36 @@ public:
 	}
 
 	template <template <class, class> class C, typename T, typename A = allocator<T>,
-		typename = typename std::enable_if_t<util::is_pod_v<T>>>
-	void write_array(C<T, A> const& container)
+		typename = typename std::enable_if_t<util::is_pod_v<T> || util::is_trivially_serializable_v<T>>>
+	void write_array(C<T, A> const& container, IntegerEncoding length_encoding = IntegerEncoding::Fixed)
 	{
 		using rd::size;
 		const int32_t& len = rd::size(container);
-		write_integral<int32_t>(static_cast<int32_t>(len));
+		write_integral<int32_t>(static_cast<int32_t>(len), length_encoding);
 		if (len > 0)
 		{
 			write(reinterpret_cast<word_t const*>(&container[0]), sizeof(T) * len);
 		}
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<T>,
-		typename = typename std::enable_if_t<!rd::util::in_heap_v<T>>>
-	void write_array(C<T, A> const& container, std::function<void(T const&)> writer)
+	template <template <class, class> class C, typename T, typename A = allocator<T>, typename F,
+		typename = typename std::enable_if_t<!rd::util::in_heap_v<T> && !util::is_same_v<std::decay_t<F>, IntegerEncoding>>>
+	void write_array(C<T, A> const& container, F&& writer, IntegerEncoding length_encoding = IntegerEncoding::Fixed)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_integral<int32_t>(size(container), length_encoding);
 		for (auto const& e : container)
 		{
 			writer(e);
 		}
 	}
 
-	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>>
-	void write_array(C<Wrapper<T>, A> const& container, std::function<void(T const&)> writer)
+	template <template <class, class> class C, typename T, typename A = allocator<Wrapper<T>>, typename F,
+		typename = typename std::enable_if_t<!util::is_same_v<std::decay_t<F>, IntegerEncoding>>>
+	void write_array(C<Wrapper<T>, A> const& container, F&& writer, IntegerEncoding length_encoding = IntegerEncoding::Fixed)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_integral<int32_t>(size(container), length_encoding);
 		for (auto const& e : container)
 		{
 			writer(*e);
@@ -183,6 +314,11 @@ public:
 
 	void write_byte_array_raw(ByteArray const& array);
 
+	/**
+	 * \brief Writes [size] bytes from [src] as is, e.g. a part of another buffer.
+	 */
+	void write_raw(word_t const* src, size_t size);
+
 	//    std::string readString() const;
 
 	//    void writeString(std::string const &value) const;
@@ -199,6 +335,21 @@ public:
 
 	uint16_t * read_char16_string();
 
+	/**
+	 * \brief Reads length-prefixed UTF-16 string straight into caller-owned storage, without intermediate copies.
+	 * \param allocate called once with the number of code units, returns storage for at least that many units
+	 * (may return nullptr for zero length)
+	 */
+	template <typename F>
+	void read_char16_string(F&& allocate)
+	{
+		const int32_t len = read_integral<int32_t>();
+		RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
+		check_available(sizeof(uint16_t) * len);
+		uint16_t* dst = allocate(static_cast<size_t>(len));
+		read(reinterpret_cast<word_t*>(dst), sizeof(uint16_t) * len);
+	}
+
 	std::wstring read_wstring();
 
 	void write_wstring(std::wstring const& value);
@@ -207,6 +358,11 @@ public:
 
 	void write_wstring(Wrapper<std::wstring> const& value);
 
+	/**
+	 * \return number of bytes \ref write_wstring takes for [value]
+	 */
+	static size_t wstring_size(wstring_view value);
+
 	DateTime read_date_time();
 
 	void write_date_time(DateTime const& date_time);
@@ -260,9 +416,8 @@ public:
 		return reader();
 	}
 
-	template <typename T>
-	typename std::enable_if_t<!std::is_abstract<T>::value> write_nullable(
-		optional<T> const& value, std::function<void(T const&)> writer)
+	template <typename T, typename F>
+	typename std::enable_if_t<!std::is_abstract<T>::value> write_nullable(optional<T> const& value, F&& writer)
 	{
 		if (!value)
 		{
@@ -1,5 +1,7 @@
 #include "protocol/MessageBroker.h"
 
+#include "util/Metrics.h"
+
 #include "spdlog/sinks/stdout_color_sinks.h"
 
 namespace rd
@@ -52,6 +54,15 @@ void MessageBroker::dispatch(RdId id, Buffer message) const
 	{	 // synchronized recursively
 		std::lock_guard<decltype(lock)> guard(lock);
 		IRdReactive const* s = subscriptions[id];
+		if (util::MetricsRegistry::is_enabled())
+		{
+			++dispatched_total;
+			// the count of a recipient goes with its subscription, so ids of ended ones don't pile up
+			if (s != nullptr)
+			{
+				++dispatched[id];
+			}
+		}
 		if (s == nullptr)
 		{
 			auto it = broker.find(id);
@@ -140,7 +151,27 @@ void MessageBroker::advise_on(Lifetime lifetime, IRdReactive const* entity) cons
 		auto key = entity->get_id();
 		IRdReactive const* value = entity;
 		subscriptions[key] = value;
-		lifetime->add_action([this, key]() { subscriptions.erase(key); });
+		lifetime->add_action([this, key]() {
+			std::lock_guard<decltype(lock)> guard(lock);
+			subscriptions.erase(key);
+			dispatched.erase(key);
+		});
+	}
+}
+
+void MessageBroker::collect_metrics(util::MetricsSnapshot& snapshot, std::string const& prefix) const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	for (auto const& it : dispatched)
+	{
+		snapshot.add(prefix + "dispatched." + to_string(it.first), static_cast<double>(it.second));
+	}
+	snapshot.add(prefix + "dispatched", static_cast<double>(dispatched_total));
+	size_t waiting = 0;
+	for (auto const& it : broker)
+	{
+		waiting += it.second.default_scheduler_messages.size() + it.second.custom_scheduler_messages.size();
 	}
+	snapshot.add(prefix + "waiting", static_cast<double>(waiting));
 }
 }	 // namespace rd
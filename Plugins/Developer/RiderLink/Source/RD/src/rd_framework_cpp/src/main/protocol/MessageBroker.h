@@ -18,6 +18,14 @@
 
 namespace rd
 {
+// region predeclared
+
+namespace util
+{
+class MetricsSnapshot;
+}
+// endregion
+
 class RD_FRAMEWORK_API Mq
 {
 public:
@@ -44,6 +52,9 @@ private:
 	IScheduler* default_scheduler = nullptr;
 	mutable rd::unordered_map<RdId, IRdReactive const*> subscriptions;
 	mutable rd::unordered_map<RdId, Mq> broker;
+	// counted while [util::MetricsRegistry::enabled] is set, per recipient only while it is subscribed
+	mutable rd::unordered_map<RdId, uint64_t> dispatched;
+	mutable uint64_t dispatched_total = 0;
 
 	mutable std::recursive_mutex lock;
 
@@ -60,6 +71,12 @@ public:
 	void dispatch(RdId id, Buffer message) const;
 
 	void advise_on(Lifetime lifetime, IRdReactive const* entity) const;
+
+	/**
+	 * \brief Reports messages dispatched so far in total, those dispatched to each currently subscribed recipient id,
+	 * and messages waiting for their recipient to be bound, under [prefix].
+	 */
+	void collect_metrics(util::MetricsSnapshot& snapshot, std::string const& prefix) const;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
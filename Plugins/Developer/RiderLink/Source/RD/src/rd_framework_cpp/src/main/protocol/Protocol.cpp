@@ -16,12 +16,15 @@ constexpr string_view Protocol::InternRootName;
 
 void Protocol::initialize() const
 {
+	static constexpr util::hash_t protocolHash = util::getPlatformIndependentHash("Protocol");
+	static constexpr RdId internRootId = RdId::Null().mix(InternRootName);
+
 	internRoot = std::make_unique<InternRoot>();
 
 	context = std::make_unique<SerializationCtx>(
-		serializers.get(), SerializationCtx::roots_t{{util::getPlatformIndependentHash("Protocol"), internRoot.get()}});
+		serializers.get(), SerializationCtx::roots_t{{protocolHash, internRoot.get()}}, integer_encoding);
 
-	internRoot->set_id(RdId::Null().mix(InternRootName));
+	internRoot->set_id(internRootId);
 	scheduler->queue([this] { internRoot->bind(lifetime, this, InternRootName); });
 }
 
@@ -48,4 +51,18 @@ SerializationCtx& Protocol::get_serialization_context() const
 	return *context;
 }
 
+void Protocol::set_integer_encoding(IntegerEncoding encoding)
+{
+	integer_encoding = encoding;
+	if (context)
+	{
+		context->set_integer_encoding(encoding);
+	}
+}
+
+IntegerEncoding Protocol::get_integer_encoding() const
+{
+	return integer_encoding;
+}
+
 }	 // namespace rd
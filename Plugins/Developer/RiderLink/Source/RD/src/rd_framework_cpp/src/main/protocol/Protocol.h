@@ -36,6 +36,8 @@ class RD_FRAMEWORK_API Protocol : /*IRdDynamic, */ public IProtocol
 
 	mutable std::unique_ptr<InternRoot> internRoot;
 
+	IntegerEncoding integer_encoding = IntegerEncoding::Fixed;
+
 	// region ctor/dtor
 private:
 	void initialize() const;
@@ -56,6 +58,16 @@ public:
 
 	SerializationCtx& get_serialization_context() const override;
 
+	/**
+	 * \brief Switches integral values, collection lengths and RdMap, RdList and RdSet op headers to [encoding].
+	 *
+	 * \details The encoding isn't negotiated: both sides must call this with the same value before any traffic
+	 * is exchanged, otherwise each misreads the other's messages.
+	 */
+	void set_integer_encoding(IntegerEncoding encoding);
+
+	IntegerEncoding get_integer_encoding() const;
+
 	static std::shared_ptr<spdlog::logger> initializationLogger;
 };
 }	 // namespace rd
@@ -98,6 +98,22 @@ public:
 		return RdId(util::getPlatformIndependentHash(tail, static_cast<util::constexpr_hash_t>(hash)));
 	}
 
+	using Suffix = util::hash_suffix;
+
+	/**
+	 * \brief Precomputes mixing of a constant name, so that id.mix(suffix(tail)) == id.mix(tail).
+	 * Meant for constexpr ids of static model members; rd-gen has to emit these constants in identify().
+	 */
+	static constexpr Suffix suffix(string_view tail)
+	{
+		return util::getPlatformIndependentHashSuffix(tail);
+	}
+
+	constexpr RdId mix(Suffix const& tail) const
+	{
+		return RdId(util::getPlatformIndependentHash(tail, static_cast<util::constexpr_hash_t>(hash)));
+	}
+
 	/*constexpr RdId mix(int32_t tail) const {
 		return RdId(util::getPlatformIndependentHash(tail, static_cast<util::constexpr_hash_t>(hash)));
 	}
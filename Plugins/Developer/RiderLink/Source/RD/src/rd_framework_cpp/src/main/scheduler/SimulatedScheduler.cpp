@@ -0,0 +1,92 @@
+#include "SimulatedScheduler.h"
+
+#include <algorithm>
+
+namespace rd
+{
+namespace test
+{
+namespace util
+{
+SimulatedScheduler::SimulatedScheduler()
+{
+	thread_id = std::this_thread::get_id();
+}
+
+void SimulatedScheduler::queue(std::function<void()> action)
+{
+	queue_at(current, std::move(action));
+}
+
+void SimulatedScheduler::queue_after(duration delay, std::function<void()> action)
+{
+	queue_at(current + delay, std::move(action));
+}
+
+void SimulatedScheduler::queue_at(duration time, std::function<void()> action)
+{
+	events.push_back(Event{(std::max)(time, current), next_sequence++, std::move(action)});
+	std::push_heap(events.begin(), events.end(), Later{});
+}
+
+void SimulatedScheduler::flush()
+{
+	run_until_idle();
+}
+
+bool SimulatedScheduler::is_active() const
+{
+	return thread_id == std::this_thread::get_id();
+}
+
+SimulatedScheduler::duration SimulatedScheduler::now() const
+{
+	return current;
+}
+
+size_t SimulatedScheduler::pending() const
+{
+	return events.size();
+}
+
+size_t SimulatedScheduler::executed_count() const
+{
+	return executed;
+}
+
+bool SimulatedScheduler::run_one()
+{
+	if (events.empty())
+	{
+		return false;
+	}
+	std::pop_heap(events.begin(), events.end(), Later{});
+	Event event = std::move(events.back());
+	events.pop_back();
+	current = event.time;
+	++executed;
+	event.action();
+	return true;
+}
+
+size_t SimulatedScheduler::run_until_idle(size_t limit)
+{
+	size_t count = 0;
+	while (count < limit && run_one())
+	{
+		++count;
+	}
+	return count;
+}
+
+void SimulatedScheduler::run_until(duration time)
+{
+	while (!events.empty() && events.front().time <= time)
+	{
+		run_one();
+	}
+	current = (std::max)(current, time);
+}
+}	 // namespace util
+}	 // namespace test
+}	 // namespace rd
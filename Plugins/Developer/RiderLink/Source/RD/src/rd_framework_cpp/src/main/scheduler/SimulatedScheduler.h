@@ -0,0 +1,116 @@
+#ifndef RD_CPP_SIMULATEDSCHEDULER_H
+#define RD_CPP_SIMULATEDSCHEDULER_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "scheduler/base/IScheduler.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace test
+{
+namespace util
+{
+/**
+ * \brief Single-threaded scheduler with virtual time, for deterministic simulations.
+ *
+ * \details Actions run in the order of their due time, actions due at the same time in the order they were queued.
+ * Time only moves when the next action is due later than now or when [run_until] is asked to advance it,
+ * so a simulation gives the same results on every run regardless of the host speed.
+ */
+class RD_FRAMEWORK_API SimulatedScheduler : public IScheduler
+{
+public:
+	using duration = std::chrono::nanoseconds;
+
+private:
+	struct Event
+	{
+		duration time;
+		uint64_t sequence;
+		std::function<void()> action;
+	};
+
+	struct Later
+	{
+		bool operator()(Event const& lhs, Event const& rhs) const
+		{
+			return lhs.time != rhs.time ? lhs.time > rhs.time : lhs.sequence > rhs.sequence;
+		}
+	};
+
+	// min-heap by (time, sequence)
+	std::vector<Event> events;
+	uint64_t next_sequence = 0;
+	duration current{0};
+	size_t executed = 0;
+
+public:
+	// region ctor/dtor
+
+	SimulatedScheduler();
+
+	virtual ~SimulatedScheduler() = default;
+	// endregion
+
+	/**
+	 * \brief Queues [action] to run at the current virtual time after the already queued ones.
+	 */
+	void queue(std::function<void()> action) override;
+
+	void queue_after(duration delay, std::function<void()> action);
+
+	void queue_at(duration time, std::function<void()> action);
+
+	/**
+	 * \brief Runs everything queued, including actions queued meanwhile.
+	 */
+	void flush() override;
+
+	bool is_active() const override;
+
+	duration now() const;
+
+	size_t pending() const;
+
+	/**
+	 * \return number of actions run since creation
+	 */
+	size_t executed_count() const;
+
+	/**
+	 * \brief Runs the earliest action moving the time to its due time.
+	 * \return false if nothing is queued
+	 */
+	bool run_one();
+
+	/**
+	 * \brief Runs actions until nothing is queued or [limit] actions have run.
+	 * \return number of actions run
+	 */
+	size_t run_until_idle(size_t limit = (std::numeric_limits<size_t>::max)());
+
+	/**
+	 * \brief Runs actions due not later than [time] and moves the time to it.
+	 */
+	void run_until(duration time);
+};
+}	 // namespace util
+}	 // namespace test
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_SIMULATEDSCHEDULER_H
@@ -2,17 +2,19 @@
 
 #include <utility>
 
-#include "ctpl_stl.h"
+#include "base/SingleConsumerExecutor.h"
 
 namespace rd
 {
 SingleThreadScheduler::SingleThreadScheduler(Lifetime lifetime, std::string name)
-	: SingleThreadSchedulerBase(std::move(name)), lifetime(lifetime)
+	: SingleThreadSchedulerBase(std::move(name)), lifetime(lifetime), metrics_lifetime_definition(lifetime)
 {
+	util::MetricsRegistry::instance().add_source(
+		metrics_lifetime_definition.lifetime, [this](util::MetricsSnapshot& snapshot) { collect_metrics(snapshot); });
 	lifetime->add_action([this]() {
 		try
 		{
-			pool->stop(true);
+			executor->stop(true);
 		}
 		catch (std::exception const& e)
 		{
@@ -4,6 +4,7 @@
 #include "base/SingleThreadSchedulerBase.h"
 
 #include "lifetime/Lifetime.h"
+#include "lifetime/LifetimeDefinition.h"
 
 #include <rd_framework_export.h>
 
@@ -14,6 +15,11 @@ class RD_FRAMEWORK_API SingleThreadScheduler : public SingleThreadSchedulerBase
 public:
 	Lifetime lifetime;
 
+private:
+	// the scheduler may be destroyed before [lifetime] ends, its metrics are reported until then
+	LifetimeDefinition metrics_lifetime_definition;
+
+public:
 	SingleThreadScheduler(Lifetime lifetime, std::string name);
 };
 }	 // namespace rd
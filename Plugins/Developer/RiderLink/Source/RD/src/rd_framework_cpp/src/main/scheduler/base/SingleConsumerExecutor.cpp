@@ -0,0 +1,324 @@
+#include "SingleConsumerExecutor.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#define RD_CPU_RELAX() _mm_pause()
+#else
+#define RD_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace rd
+{
+namespace
+{
+constexpr int SPIN_ITERATIONS = 256;
+
+constexpr int YIELD_ITERATIONS = 64;
+
+size_t round_up_capacity(size_t capacity)
+{
+	size_t result = 2;
+	while (result < capacity)
+	{
+		result *= 2;
+	}
+	return result;
+}
+}	 // namespace
+
+struct SingleConsumerExecutor::State
+{
+	struct Slot
+	{
+		std::atomic<size_t> sequence{0};
+		task_t task;
+	};
+
+	const size_t mask;
+	std::unique_ptr<Slot[]> slots;
+
+	alignas(64) std::atomic<size_t> enqueue_pos{0};
+	// consumer thread only
+	alignas(64) size_t dequeue_pos = 0;
+
+	std::atomic<bool> overflowed{false};
+	std::mutex overflow_lock;
+	std::deque<task_t> overflow;
+
+	std::mutex park_lock;
+	std::condition_variable park_cv;
+	std::atomic<bool> parked{false};
+	// spinning only delays producers on a single core
+	const bool spin = std::thread::hardware_concurrency() > 1;
+
+	std::atomic<bool> stopping{false};
+	std::atomic<bool> discarding{false};
+	std::atomic<bool> closed{false};
+	// producers between their check of [closed] and the end of queueing
+	std::atomic<size_t> pushing{0};
+
+	runner_t runner;
+
+	State(runner_t runner, size_t capacity);
+
+	bool try_enqueue(task_t& task);
+
+	bool try_dequeue(task_t& task);
+
+	bool has_work() const;
+
+	/**
+	 * \brief Runs one task from the ring or everything accumulated in the overflow list.
+	 * \return false if there was nothing to run
+	 */
+	bool run_pending();
+
+	void wait_for_work();
+
+	void wake();
+
+	void close();
+
+	void run();
+
+	bool push(task_t task);
+
+	void stop(bool drain);
+};
+
+SingleConsumerExecutor::State::State(runner_t runner, size_t capacity)
+	: mask(round_up_capacity(capacity) - 1), slots(new Slot[mask + 1]), runner(std::move(runner))
+{
+	for (size_t i = 0; i <= mask; ++i)
+	{
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+SingleConsumerExecutor::SingleConsumerExecutor(runner_t runner, size_t capacity)
+	: state(std::make_shared<State>(std::move(runner), capacity))
+{
+	thread = std::thread([state = state] { state->run(); });
+}
+
+SingleConsumerExecutor::~SingleConsumerExecutor()
+{
+	if (thread.get_id() == std::this_thread::get_id())
+	{
+		// the task destroying the executor may take down what the runner refers to, so nothing runs after it
+		state->stop(false);
+		thread.detach();
+		return;
+	}
+	stop(true);
+}
+
+bool SingleConsumerExecutor::State::try_enqueue(task_t& task)
+{
+	size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true)
+	{
+		slot = &slots[pos & mask];
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+		if (diff == 0)
+		{
+			if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			// the consumer hasn't freed the slot of the previous lap yet
+			return false;
+		}
+		else
+		{
+			pos = enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+	slot->task = std::move(task);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool SingleConsumerExecutor::State::try_dequeue(task_t& task)
+{
+	Slot& slot = slots[dequeue_pos & mask];
+	if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos + 1)
+	{
+		return false;
+	}
+	task = std::move(slot.task);
+	slot.task = nullptr;
+	slot.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+	++dequeue_pos;
+	return true;
+}
+
+bool SingleConsumerExecutor::State::has_work() const
+{
+	return slots[dequeue_pos & mask].sequence.load(std::memory_order_acquire) == dequeue_pos + 1 ||
+		   overflowed.load(std::memory_order_acquire);
+}
+
+bool SingleConsumerExecutor::State::run_pending()
+{
+	task_t task;
+	if (try_dequeue(task))
+	{
+		runner(task);
+		return true;
+	}
+	if (!overflowed.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+	// the ring is empty and producers queue into the overflow list until it's drained
+	std::deque<task_t> tasks;
+	{
+		std::lock_guard<std::mutex> guard(overflow_lock);
+		tasks.swap(overflow);
+		overflowed.store(false, std::memory_order_release);
+	}
+	for (auto& overflow_task : tasks)
+	{
+		if (discarding.load(std::memory_order_relaxed))
+		{
+			break;
+		}
+		runner(overflow_task);
+	}
+	return true;
+}
+
+void SingleConsumerExecutor::State::wait_for_work()
+{
+	for (int i = 0; spin && i < SPIN_ITERATIONS + YIELD_ITERATIONS; ++i)
+	{
+		if (has_work() || stopping.load(std::memory_order_acquire))
+		{
+			return;
+		}
+		if (i < SPIN_ITERATIONS)
+		{
+			RD_CPU_RELAX();
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	std::unique_lock<std::mutex> guard(park_lock);
+	parked.store(true, std::memory_order_relaxed);
+	// pairs with the fence in wake: either the producer sees [parked] or we see its task
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (has_work() || stopping.load(std::memory_order_acquire))
+	{
+		parked.store(false, std::memory_order_relaxed);
+		return;
+	}
+	park_cv.wait(guard, [this] { return !parked.load(std::memory_order_relaxed); });
+}
+
+void SingleConsumerExecutor::State::wake()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (parked.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> guard(park_lock);
+		parked.store(false, std::memory_order_relaxed);
+		park_cv.notify_one();
+	}
+}
+
+void SingleConsumerExecutor::State::run()
+{
+	while (!discarding.load(std::memory_order_relaxed))
+	{
+		if (run_pending())
+		{
+			continue;
+		}
+		if (stopping.load(std::memory_order_acquire))
+		{
+			break;
+		}
+		wait_for_work();
+	}
+	close();
+}
+
+void SingleConsumerExecutor::State::close()
+{
+	closed.store(true, std::memory_order_seq_cst);
+	// pairs with push: a producer either sees [closed] or is waited for here, and its task runs as it was accepted
+	while (pushing.load(std::memory_order_seq_cst) != 0)
+	{
+		std::this_thread::yield();
+	}
+	while (!discarding.load(std::memory_order_relaxed) && run_pending())
+	{
+	}
+}
+
+bool SingleConsumerExecutor::State::push(task_t task)
+{
+	pushing.fetch_add(1, std::memory_order_seq_cst);
+	if (closed.load(std::memory_order_seq_cst))
+	{
+		pushing.fetch_sub(1, std::memory_order_release);
+		return false;
+	}
+	if (overflowed.load(std::memory_order_acquire) || !try_enqueue(task))
+	{
+		std::lock_guard<std::mutex> guard(overflow_lock);
+		overflow.push_back(std::move(task));
+		overflowed.store(true, std::memory_order_release);
+	}
+	pushing.fetch_sub(1, std::memory_order_release);
+	wake();
+	return true;
+}
+
+void SingleConsumerExecutor::State::stop(bool drain)
+{
+	if (!drain)
+	{
+		discarding.store(true, std::memory_order_relaxed);
+	}
+	stopping.store(true, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> guard(park_lock);
+		parked.store(false, std::memory_order_relaxed);
+		park_cv.notify_one();
+	}
+}
+
+bool SingleConsumerExecutor::push(task_t task)
+{
+	return state->push(std::move(task));
+}
+
+void SingleConsumerExecutor::stop(bool drain)
+{
+	state->stop(drain);
+	if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+	{
+		thread.join();
+	}
+}
+
+std::thread::id SingleConsumerExecutor::get_thread_id() const
+{
+	return thread.get_id();
+}
+}	 // namespace rd
@@ -0,0 +1,82 @@
+#ifndef RD_CPP_SINGLECONSUMEREXECUTOR_H
+#define RD_CPP_SINGLECONSUMEREXECUTOR_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Runs tasks queued from any thread on one dedicated thread, in the order they were queued.
+ *
+ * \details Tasks are moved into slots of a preallocated ring (bounded MPSC queue with per-slot sequence numbers),
+ * so queueing doesn't allocate beyond what the std::function itself needs and doesn't take a lock.
+ * When the ring is full, tasks go to a locked overflow list until the consumer drains it, which keeps the order.
+ * An idle consumer spins for a short while before parking on a condition variable, producers only touch
+ * the condition variable when the consumer is parked.
+ * The executor may be destroyed from its own thread, e.g. by a task terminating the scheduler's lifetime: the remaining
+ * tasks are dropped then, since whatever the runner refers to may go away together with the executor.
+ */
+class RD_FRAMEWORK_API SingleConsumerExecutor
+{
+public:
+	using task_t = std::function<void()>;
+
+	/**
+	 * \brief Executes a task on the consumer thread, responsible for handling its exceptions.
+	 */
+	using runner_t = std::function<void(task_t&)>;
+
+	static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+private:
+	// everything the consumer thread touches, owned by the thread as well: it may outlive an executor destroyed from it
+	struct State;
+
+	std::shared_ptr<State> state;
+	std::thread thread;
+
+public:
+	// region ctor/dtor
+
+	/**
+	 * \param capacity number of ring slots, rounded up to a power of two
+	 */
+	explicit SingleConsumerExecutor(runner_t runner, size_t capacity = DEFAULT_CAPACITY);
+
+	SingleConsumerExecutor(SingleConsumerExecutor const&) = delete;
+
+	SingleConsumerExecutor& operator=(SingleConsumerExecutor const&) = delete;
+
+	~SingleConsumerExecutor();
+	// endregion
+
+	/**
+	 * \return false if the executor is stopped and [task] won't run, a task accepted by the executor is run
+	 * unless it is stopped with drain = false
+	 */
+	bool push(task_t task);
+
+	/**
+	 * \brief Stops the consumer thread and waits for it unless called from it.
+	 * \param drain whether tasks queued before the thread exits are run, otherwise they are dropped
+	 */
+	void stop(bool drain);
+
+	std::thread::id get_thread_id() const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_SINGLECONSUMEREXECUTOR_H
@@ -2,37 +2,35 @@
 
 #include "util/core_util.h"
 
-#include "ctpl_stl.h"
+#include "SingleConsumerExecutor.h"
 #include "spdlog/include/spdlog/sinks/stdout_color_sinks.h"
 
 namespace rd
 {
-SingleThreadSchedulerBase::PoolTask::PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler)
-	: f(std::move(f)), scheduler(scheduler)
-{
-}
-
-void SingleThreadSchedulerBase::PoolTask::operator()(int id) const
+void SingleThreadSchedulerBase::execute(std::function<void()>& action)
 {
 	try
 	{
-		f();
-		--scheduler->tasks_executing;
+		action();
+		--tasks_executing;
+		if (util::MetricsRegistry::is_enabled())
+		{
+			executed_tasks.add();
+		}
 	}
 	catch (std::exception const& e)
 	{
-		scheduler->log->error("Background task failed, scheduler={}, thread_id={} | {}", scheduler->name, id, e.what());
-		--scheduler->tasks_executing;
+		log->error("Background task failed, scheduler={} | {}", name, e.what());
+		--tasks_executing;
 	}
 }
 
 SingleThreadSchedulerBase::SingleThreadSchedulerBase(std::string name)
 	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
 	, name(std::move(name))
-	, pool(std::make_unique<ctpl::thread_pool>(1))
+	, executor(std::make_unique<SingleConsumerExecutor>([this](std::function<void()>& action) { execute(action); }))
 {
-	RD_ASSERT_THROW_MSG(pool->size() == 1, "Thread pool wasn't properly initalized");
-	thread_id = pool->get_thread(0).get_id();
+	thread_id = executor->get_thread_id();
 }
 
 void SingleThreadSchedulerBase::flush()
@@ -48,8 +46,11 @@ void SingleThreadSchedulerBase::flush()
 void SingleThreadSchedulerBase::queue(std::function<void()> action)
 {
 	++tasks_executing;
-	PoolTask task(action, this);
-	pool->push(std::move(task));
+	if (!executor->push(std::move(action)))
+	{
+		--tasks_executing;
+		log->trace("Task is queued after {} is stopped, it won't run", name);
+	}
 }
 
 bool SingleThreadSchedulerBase::is_active() const
@@ -57,5 +58,11 @@ bool SingleThreadSchedulerBase::is_active() const
 	return thread_id == std::this_thread::get_id();
 }
 
+void SingleThreadSchedulerBase::collect_metrics(util::MetricsSnapshot& snapshot) const
+{
+	snapshot.add("scheduler." + name + ".backlog", static_cast<double>(tasks_executing.load()));
+	snapshot.add("scheduler." + name + ".executed", static_cast<double>(executed_tasks.get()));
+}
+
 SingleThreadSchedulerBase::~SingleThreadSchedulerBase() = default;
 }	 // namespace rd
\ No newline at end of file
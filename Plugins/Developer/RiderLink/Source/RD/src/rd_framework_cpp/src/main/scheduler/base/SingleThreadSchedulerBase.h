@@ -8,19 +8,20 @@
 
 #include "scheduler/base/IScheduler.h"
 #include "lifetime/Lifetime.h"
+#include "util/Metrics.h"
 #include "spdlog/spdlog.h"
 
 #include <utility>
 
 #include <rd_framework_export.h>
 
-namespace ctpl
-{
-class thread_pool;
-}
-
 namespace rd
 {
+// region predeclared
+
+class SingleConsumerExecutor;
+// endregion
+
 class RD_FRAMEWORK_API SingleThreadSchedulerBase : public IScheduler
 {
 protected:
@@ -29,18 +30,11 @@ protected:
 
 	std::atomic_uint32_t tasks_executing{0};
 	std::atomic_uint32_t active{0};
-	std::unique_ptr<ctpl::thread_pool> pool;
+	// counted while [util::MetricsRegistry::enabled] is set
+	util::Counter executed_tasks;
+	std::unique_ptr<SingleConsumerExecutor> executor;
 
-	class PoolTask
-	{
-		std::function<void()> f;
-		SingleThreadSchedulerBase* scheduler;
-
-	public:
-		explicit PoolTask(std::function<void()> f, SingleThreadSchedulerBase* scheduler);
-
-		void operator()(int id) const;
-	};
+	void execute(std::function<void()>& action);
 
 public:
 	// region ctor/dtor
@@ -54,6 +48,11 @@ public:
 	void queue(std::function<void()> action) override;
 
 	bool is_active() const override;
+
+	/**
+	 * \brief Reports tasks queued but not finished yet and tasks executed as "scheduler.[name].*".
+	 */
+	void collect_metrics(util::MetricsSnapshot& snapshot) const;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
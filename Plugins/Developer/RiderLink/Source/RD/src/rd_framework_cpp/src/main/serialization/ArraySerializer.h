@@ -12,15 +12,55 @@ template <typename S, template <class, class> class C, typename T = typename uti
 	typename A = allocator<value_or_wrapper<T>>>
 class ArraySerializer
 {
+	// elements written by default serializer of trivially serializable type may be copied in bulk
+	using bulk_t = util::bool_constant<util::is_same_v<S, Polymorphic<T>> && util::is_trivially_serializable_v<T>>;
+
+	static bool can_copy_bulk(SerializationCtx const& ctx)
+	{
+		// compact encoding writes each integral element as varint
+		return !std::is_integral<T>::value || ctx.get_integer_encoding() == IntegerEncoding::Fixed;
+	}
+
+	static C<value_or_wrapper<T>, A> read(SerializationCtx& ctx, Buffer& buffer, std::true_type)
+	{
+		if (can_copy_bulk(ctx))
+		{
+			return buffer.read_array<C, T, A>(ctx.get_integer_encoding());
+		}
+		return read(ctx, buffer, std::false_type{});
+	}
+
+	static C<value_or_wrapper<T>, A> read(SerializationCtx& ctx, Buffer& buffer, std::false_type)
+	{
+		return buffer.read_array<C, T, A>([&] { return S::read(ctx, buffer); }, ctx.get_integer_encoding());
+	}
+
+	static void write(SerializationCtx& ctx, Buffer& buffer, C<value_or_wrapper<T>, A> const& value, std::true_type)
+	{
+		if (can_copy_bulk(ctx))
+		{
+			buffer.write_array(value, ctx.get_integer_encoding());
+			return;
+		}
+		write(ctx, buffer, value, std::false_type{});
+	}
+
+	static void write(SerializationCtx& ctx, Buffer& buffer, C<value_or_wrapper<T>, A> const& value, std::false_type)
+	{
+		// let overload be deduced: naming C<Wrapper<T>, A> with allocator of T is ill-formed for some containers
+		buffer.write_array(
+			value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); }, ctx.get_integer_encoding());
+	}
+
 public:
 	static C<value_or_wrapper<T>, A> read(SerializationCtx& ctx, Buffer& buffer)
 	{
-		return buffer.read_array<C, T, A>([&] { return S::read(ctx, buffer); });
+		return read(ctx, buffer, bulk_t{});
 	}
 
 	static void write(SerializationCtx& ctx, Buffer& buffer, C<value_or_wrapper<T>, A> const& value)
 	{
-		buffer.write_array<C, T, A>(value, [&](T const& inner_value) { S::write(ctx, buffer, inner_value); });
+		write(ctx, buffer, value, bulk_t{});
 	}
 };
 }	 // namespace rd
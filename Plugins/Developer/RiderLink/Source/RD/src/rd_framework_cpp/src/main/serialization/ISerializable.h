@@ -2,6 +2,7 @@
 #define RD_CPP_ISERIALIZABLE_H
 
 #include <string>
+#include <cstddef>
 
 #include <rd_framework_export.h>
 
@@ -24,6 +25,13 @@ public:
 	virtual ~ISerializable() = default;
 
 	virtual void write(SerializationCtx& ctx, Buffer& buffer) const = 0;
+
+	/**
+	 * \return number of bytes \ref write is expected to produce, or 0 if it isn't known in advance.
+	 * Only a capacity hint: the destination buffer is grown once up front and still grows on demand.
+	 * rd-gen has to emit overrides for model classes; generated classes in this tree don't override it yet.
+	 */
+	virtual size_t serialized_size(SerializationCtx& ctx) const;
 };
 
 /**
@@ -3,16 +3,12 @@
 
 #include "protocol/Buffer.h"
 #include "base/RdReactiveBase.h"
+#include "serialization/SerializationCtx.h"
 
 #include <type_traits>
 
 namespace rd
 {
-// region predeclared
-
-class SerializationCtx;
-// endregion
-
 /**
  * \brief Maintains "SerDes" for statically polymorphic type [T].
  * Requires static "read" and "write" methods as in common case below.
@@ -37,20 +33,51 @@ public:
 	{
 		value->write(ctx, buffer);
 	}
+
+	template <typename U = T>
+	inline static auto serialized_size(SerializationCtx& ctx, U const& value) -> decltype(value.serialized_size(ctx))
+	{
+		return value.serialized_size(ctx);
+	}
+
+	template <typename U = T>
+	inline static auto serialized_size(SerializationCtx& ctx, Wrapper<U> const& value) -> decltype(value->serialized_size(ctx))
+	{
+		return value->serialized_size(ctx);
+	}
+
+	template <typename U = T>
+	inline static auto write_patch(SerializationCtx& ctx, Buffer& buffer, U const& base, U const& value)
+		-> decltype(value.write_patch(ctx, buffer, base))
+	{
+		value.write_patch(ctx, buffer, base);
+	}
+
+	template <typename U = T>
+	inline static auto read_patch(SerializationCtx& ctx, Buffer& buffer, U const& base)
+		-> decltype(U::read_patch(ctx, buffer, base))
+	{
+		return U::read_patch(ctx, buffer, base);
+	}
 };
 
 template <typename T>
 class Polymorphic<T, typename std::enable_if_t<std::is_integral<T>::value>>
 {
 public:
-	inline static T read(SerializationCtx& /*ctx*/, Buffer& buffer)
+	inline static T read(SerializationCtx& ctx, Buffer& buffer)
 	{
-		return buffer.read_integral<T>();
+		return buffer.read_integral<T>(ctx.get_integer_encoding());
 	}
 
-	inline static void write(SerializationCtx& /*ctx*/, Buffer& buffer, T const& value)
+	inline static void write(SerializationCtx& ctx, Buffer& buffer, T const& value)
 	{
-		buffer.write_integral<T>(value);
+		buffer.write_integral<T>(value, ctx.get_integer_encoding());
+	}
+
+	inline static size_t serialized_size(SerializationCtx& ctx, T const& value)
+	{
+		return Buffer::integral_size<T>(value, ctx.get_integer_encoding());
 	}
 };
 
@@ -67,6 +94,31 @@ public:
 	{
 		buffer.write_floating_point<T>(value);
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return sizeof(T);
+	}
+};
+
+template <typename T>
+class Polymorphic<T, typename std::enable_if_t<std::is_class<T>::value && util::is_trivially_serializable_v<T>>>
+{
+public:
+	inline static T read(SerializationCtx& /*ctx*/, Buffer& buffer)
+	{
+		return buffer.read_trivial<T>();
+	}
+
+	inline static void write(SerializationCtx& /*ctx*/, Buffer& buffer, T const& value)
+	{
+		buffer.write_trivial<T>(value);
+	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return sizeof(T);
+	}
 };
 
 // class Polymorphic<int, void>;
@@ -76,14 +128,21 @@ class Polymorphic<C<T, A>, typename std::enable_if_t<!util::is_base_of_v<RdReact
 													 !util::is_same_v<Wrapper<T, A>, C<T, A>>>>
 {
 public:
-	inline static C<T, A> read(SerializationCtx& /*ctx*/, Buffer& buffer)
+	inline static C<T, A> read(SerializationCtx& ctx, Buffer& buffer)
+	{
+		return buffer.read_array<C, T, A>(ctx.get_integer_encoding());
+	}
+
+	inline static void write(SerializationCtx& ctx, Buffer& buffer, C<T, A> const& value)
 	{
-		return buffer.read_array<C, T, A>();
+		buffer.write_array<C, T, A>(value, ctx.get_integer_encoding());
 	}
 
-	inline static void write(SerializationCtx& /*ctx*/, Buffer& buffer, C<T, A> const& value)
+	inline static size_t serialized_size(SerializationCtx& ctx, C<T, A> const& value)
 	{
-		buffer.write_array<C, T, A>(value);
+		using rd::size;
+		const int32_t len = size(value);
+		return Buffer::integral_size<int32_t>(len, ctx.get_integer_encoding()) + sizeof(T) * len;
 	}
 };
 
@@ -100,6 +159,11 @@ public:
 	{
 		buffer.write_bool(value);
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, bool const& /*value*/)
+	{
+		return sizeof(uint8_t);
+	}
 };
 
 template <>
@@ -115,6 +179,11 @@ public:
 	{
 		buffer.write_char(value);
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, wchar_t const& /*value*/)
+	{
+		return sizeof(uint16_t);
+	}
 };
 
 template <>
@@ -135,6 +204,16 @@ public:
 	{
 		buffer.write_wstring(*value);
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, std::wstring const& value)
+	{
+		return Buffer::wstring_size(value);
+	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, Wrapper<std::wstring> const& value)
+	{
+		return Buffer::wstring_size(*value);
+	}
 };
 
 template <>
@@ -150,6 +229,11 @@ public:
 	{
 		buffer.write_date_time(value);
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, DateTime const& /*value*/)
+	{
+		return sizeof(int64_t);
+	}
 };
 
 template <>
@@ -164,6 +248,11 @@ public:
 	inline static void write(SerializationCtx& /*ctx*/, Buffer& /*buffer*/, Void const& /*value*/)
 	{
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, Void const& /*value*/)
+	{
+		return 0;
+	}
 };
 
 template <typename T>
@@ -179,6 +268,11 @@ public:
 	{
 		value.write(ctx, buffer);
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return sizeof(RdId::hash_t);
+	}
 };
 
 template <typename T>
@@ -194,6 +288,11 @@ public:
 	{
 		buffer.write_enum<T>(value);
 	}
+
+	inline static size_t serialized_size(SerializationCtx& /*ctx*/, T const& /*value*/)
+	{
+		return sizeof(int32_t);
+	}
 };
 
 template <typename T>
@@ -209,6 +308,17 @@ public:
 	{
 		buffer.write_nullable<T>(value, [&ctx, &buffer](T const& v) { Polymorphic<T>::write(ctx, buffer, v); });
 	}
+
+	template <typename U = T>
+	inline static auto serialized_size(SerializationCtx& ctx, optional<U> const& value)
+		-> decltype(Polymorphic<U>::serialized_size(ctx, *value))
+	{
+		if (!value)
+			return sizeof(uint8_t);
+		const size_t size = Polymorphic<U>::serialized_size(ctx, *value);
+		// an unknown size stays unknown rather than becoming a one byte guess
+		return size ? sizeof(uint8_t) + size : 0;
+	}
 };
 
 template <typename T, typename A>
@@ -219,7 +329,63 @@ public:
 	{
 		value->write(ctx, buffer);
 	}
+
+	template <typename U = T>
+	inline static auto serialized_size(SerializationCtx& ctx, Wrapper<U, A> const& value)
+		-> decltype(value->serialized_size(ctx))
+	{
+		return value->serialized_size(ctx);
+	}
+};
+
+namespace util
+{
+template <typename S, typename T, typename = void>
+struct has_serialized_size : std::false_type
+{
 };
+
+template <typename S, typename T>
+struct has_serialized_size<S, T,
+	decltype(static_cast<void>(S::serialized_size(std::declval<SerializationCtx&>(), std::declval<T const&>())))>
+	: std::true_type
+{
+};
+
+/**
+ * \brief Whether serializer [S] can write [T] as a patch against a previous value and read it back.
+ */
+template <typename S, typename T, typename = void>
+struct has_patch : std::false_type
+{
+};
+
+template <typename S, typename T>
+struct has_patch<S, T,
+	decltype(static_cast<void>(S::write_patch(std::declval<SerializationCtx&>(), std::declval<Buffer&>(),
+								   std::declval<T const&>(), std::declval<T const&>())),
+		static_cast<void>(S::read_patch(std::declval<SerializationCtx&>(), std::declval<Buffer&>(), std::declval<T const&>())))>
+	: std::true_type
+{
+};
+}	 // namespace util
+
+/**
+ * \return number of bytes serializer [S] writes for [value] if [S] can tell it in advance, 0 otherwise
+ */
+template <typename S, typename T>
+typename std::enable_if_t<util::has_serialized_size<S, T>::value, size_t> serialized_size_of(
+	SerializationCtx& ctx, T const& value)
+{
+	return S::serialized_size(ctx, value);
+}
+
+template <typename S, typename T>
+typename std::enable_if_t<!util::has_serialized_size<S, T>::value, size_t> serialized_size_of(
+	SerializationCtx& /*ctx*/, T const& /*value*/)
+{
+	return 0;
+}
 }	 // namespace rd
 
 #endif	  // RD_CPP_POLYMORPHIC_H
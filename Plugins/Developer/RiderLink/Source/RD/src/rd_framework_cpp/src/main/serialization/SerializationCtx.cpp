@@ -6,8 +6,8 @@ namespace rd
 
 //	SerializationCtx::SerializationCtx(const Serializers *const serializers) : serializers(serializers) {}
 
-SerializationCtx::SerializationCtx(const Serializers* serializers, roots_t intern_roots)
-	: serializers(serializers), intern_roots(std::move(intern_roots))
+SerializationCtx::SerializationCtx(const Serializers* serializers, roots_t intern_roots, IntegerEncoding integer_encoding)
+	: serializers(serializers), integer_encoding(integer_encoding), intern_roots(std::move(intern_roots))
 {
 }
 
@@ -22,11 +22,21 @@ SerializationCtx SerializationCtx::withInternRootsHere(
 		withId(root, owner.get_id().mix(".").mix(name));
 		next_roots.emplace(util::getPlatformIndependentHash(item), &root);
 	}
-	return SerializationCtx(serializers, std::move(next_roots));
+	return SerializationCtx(serializers, std::move(next_roots), integer_encoding);
 }
 
 Serializers const& SerializationCtx::get_serializers() const
 {
 	return *serializers;
 }
+
+IntegerEncoding SerializationCtx::get_integer_encoding() const
+{
+	return integer_encoding;
+}
+
+void SerializationCtx::set_integer_encoding(IntegerEncoding value)
+{
+	integer_encoding = value;
+}
 }	 // namespace rd
@@ -35,6 +35,8 @@ class RD_FRAMEWORK_API SerializationCtx
 {
 	Serializers const* serializers = nullptr;
 
+	IntegerEncoding integer_encoding = IntegerEncoding::Fixed;
+
 public:
 	using roots_t = rd::unordered_map<util::hash_t, InternRoot const*>;
 
@@ -54,7 +56,8 @@ public:
 
 	//		explicit SerializationCtx(const Serializers *serializers = nullptr);
 
-	explicit SerializationCtx(const Serializers* serializers, roots_t intern_roots = {});
+	explicit SerializationCtx(
+		const Serializers* serializers, roots_t intern_roots = {}, IntegerEncoding integer_encoding = IntegerEncoding::Fixed);
 
 	SerializationCtx withInternRootsHere(RdBindableBase const& owner, std::initializer_list<std::string> new_roots) const;
 
@@ -68,6 +71,13 @@ public:
 	void writeInterned(Buffer& buffer, Wrapper<T> const& value, F&& writeValueDelegate);
 
 	Serializers const& get_serializers() const;
+
+	/**
+	 * \brief Encoding of integral values and collection lengths configured for the owning protocol.
+	 */
+	IntegerEncoding get_integer_encoding() const;
+
+	void set_integer_encoding(IntegerEncoding value);
 };
 }	 // namespace rd
 
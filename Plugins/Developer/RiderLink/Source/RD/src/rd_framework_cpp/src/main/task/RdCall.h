@@ -129,8 +129,8 @@ private:
 			sync_task_id = task_id;
 		}
 
-		get_wire()->send(rdid, [&](Buffer& buffer) {
-			spdlog::get("logSend")->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
+		get_wire()->send_inline(rdid, [&](Buffer& buffer) {
+			log_send()->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
 				to_string(task_id), to_string(request));
 			task_id.write(buffer);
 			ReqSer::write(get_serialization_context(), buffer, request);
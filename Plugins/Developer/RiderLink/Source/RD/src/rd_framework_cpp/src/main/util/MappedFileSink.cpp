@@ -0,0 +1,87 @@
+#include "MappedFileSink.h"
+
+#include "spdlog/pattern_formatter.h"
+
+#include <cstring>
+#include <vector>
+
+namespace rd
+{
+namespace util
+{
+namespace
+{
+std::atomic<uint64_t> next_sink_id{1};
+
+struct ThreadFormatter
+{
+	uint64_t sink_id;
+	uint64_t generation;
+	std::unique_ptr<spdlog::formatter> formatter;
+};
+
+thread_local std::vector<ThreadFormatter> thread_formatters;
+thread_local spdlog::memory_buf_t thread_buffer;
+}	 // namespace
+
+MappedFileSink::MappedFileSink(spdlog::filename_t base_filename, size_t segment_size, size_t max_files)
+	: sink_id(next_sink_id.fetch_add(1))
+	, formatter(std::make_unique<spdlog::pattern_formatter>())
+	, log_file(std::move(base_filename), segment_size, max_files)
+{
+}
+
+MappedFileSink::~MappedFileSink() = default;
+
+void MappedFileSink::log(const spdlog::details::log_msg& msg)
+{
+	spdlog::memory_buf_t& buffer = thread_buffer;
+	buffer.clear();
+	thread_formatter().format(msg, buffer);
+	log_file.append(buffer.size(), [&buffer](char* data) { memcpy(data, buffer.data(), buffer.size()); });
+}
+
+spdlog::formatter& MappedFileSink::thread_formatter()
+{
+	const uint64_t generation = formatter_generation.load(std::memory_order_acquire);
+	for (auto& it : thread_formatters)
+	{
+		if (it.sink_id == sink_id)
+		{
+			if (it.generation != generation)
+			{
+				std::lock_guard<decltype(formatter_lock)> guard(formatter_lock);
+				it.formatter = formatter->clone();
+				it.generation = formatter_generation.load(std::memory_order_relaxed);
+			}
+			return *it.formatter;
+		}
+	}
+	std::lock_guard<decltype(formatter_lock)> guard(formatter_lock);
+	thread_formatters.push_back(ThreadFormatter{sink_id, formatter_generation.load(std::memory_order_relaxed), formatter->clone()});
+	return *thread_formatters.back().formatter;
+}
+
+void MappedFileSink::flush()
+{
+	log_file.flush();
+}
+
+void MappedFileSink::set_pattern(const std::string& pattern)
+{
+	set_formatter(std::make_unique<spdlog::pattern_formatter>(pattern));
+}
+
+void MappedFileSink::set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter)
+{
+	std::lock_guard<decltype(formatter_lock)> guard(formatter_lock);
+	formatter = std::move(sink_formatter);
+	formatter_generation.fetch_add(1, std::memory_order_release);
+}
+
+spdlog::filename_t MappedFileSink::filename()
+{
+	return log_file.filename();
+}
+}	 // namespace util
+}	 // namespace rd
@@ -0,0 +1,82 @@
+#ifndef RD_CPP_MAPPEDFILESINK_H
+#define RD_CPP_MAPPEDFILESINK_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "util/MappedLog.h"
+
+#include "spdlog/sinks/sink.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief spdlog sink for heavy trace logging, appending records to a [MappedLog].
+ *
+ * \details Each thread formats records with a formatter of its own and copies them straight into the mapped segment,
+ * so loggers don't serialize on a mutex or a write call. Segments are named like [rotating_file_sink] files
+ * ("trace.3.log") and numbered on from the segments already there, at most [max_files] of them are kept, 0 keeps all.
+ */
+class RD_FRAMEWORK_API MappedFileSink final : public spdlog::sinks::sink
+{
+public:
+	static constexpr size_t DEFAULT_SEGMENT_SIZE = MappedLog::DEFAULT_SEGMENT_SIZE;
+
+private:
+	// unique per sink, identifies the formatters cached by threads
+	const uint64_t sink_id;
+	std::atomic<uint64_t> formatter_generation{0};
+	std::mutex formatter_lock;
+	std::unique_ptr<spdlog::formatter> formatter;
+
+	MappedLog log_file;
+
+	spdlog::formatter& thread_formatter();
+
+public:
+	// region ctor/dtor
+
+	explicit MappedFileSink(spdlog::filename_t base_filename, size_t segment_size = DEFAULT_SEGMENT_SIZE,
+		size_t max_files = MappedLog::DEFAULT_MAX_FILES);
+
+	MappedFileSink(MappedFileSink const&) = delete;
+
+	MappedFileSink& operator=(MappedFileSink const&) = delete;
+
+	~MappedFileSink() override;
+	// endregion
+
+	void log(const spdlog::details::log_msg& msg) override;
+
+	/**
+	 * \brief Schedules write-back of the active segment, records are already visible to readers of the file.
+	 */
+	void flush() override;
+
+	void set_pattern(const std::string& pattern) override;
+
+	void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override;
+
+	/**
+	 * \brief File of the active segment.
+	 */
+	spdlog::filename_t filename();
+};
+}	 // namespace util
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_MAPPEDFILESINK_H
@@ -0,0 +1,509 @@
+#include "MappedLog.h"
+
+#include "spdlog/details/file_helper.h"
+#include "spdlog/details/os.h"
+#include "spdlog/fmt/fmt.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+namespace rd
+{
+namespace util
+{
+namespace
+{
+/**
+ * \return numbers of the segments [basename].N[ext] already in the directory, in ascending order
+ */
+std::vector<size_t> existing_segments(spdlog::filename_t const& basename, spdlog::filename_t const& ext)
+{
+	const spdlog::filename_t dir = spdlog::details::os::dir_name(basename);
+	const spdlog::filename_t prefix = basename.substr(dir.empty() ? 0 : dir.size() + 1) + SPDLOG_FILENAME_T(".");
+
+	std::vector<size_t> indices;
+	auto add = [&](spdlog::filename_t const& name) {
+		if (name.size() <= prefix.size() + ext.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+			name.compare(name.size() - ext.size(), ext.size(), ext) != 0)
+		{
+			return;
+		}
+		size_t index = 0;
+		for (size_t i = prefix.size(); i < name.size() - ext.size(); ++i)
+		{
+			if (name[i] < '0' || name[i] > '9')
+			{
+				return;
+			}
+			index = index * 10 + static_cast<size_t>(name[i] - '0');
+		}
+		indices.push_back(index);
+	};
+
+#ifdef _WIN32
+	const spdlog::filename_t pattern = basename + SPDLOG_FILENAME_T(".*") + ext;
+#ifdef SPDLOG_WCHAR_FILENAMES
+	WIN32_FIND_DATAW data;
+	HANDLE find = FindFirstFileW(pattern.c_str(), &data);
+#else
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA(pattern.c_str(), &data);
+#endif
+	if (find != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			add(data.cFileName);
+		}
+#ifdef SPDLOG_WCHAR_FILENAMES
+		while (FindNextFileW(find, &data));
+#else
+		while (FindNextFileA(find, &data));
+#endif
+		FindClose(find);
+	}
+#else
+	if (DIR* directory = opendir(dir.empty() ? "." : dir.c_str()))
+	{
+		while (dirent* entry = readdir(directory))
+		{
+			add(entry->d_name);
+		}
+		closedir(directory);
+	}
+#endif
+	std::sort(indices.begin(), indices.end());
+	return indices;
+}
+}	 // namespace
+
+/**
+ * \brief File mapped into memory at its full size, truncated to the written length on close.
+ */
+class MappedLog::MappedFile
+{
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+	char* data_ = nullptr;
+	size_t size = 0;
+	bool created_ = false;
+
+public:
+	// region ctor/dtor
+
+	MappedFile() = default;
+
+	MappedFile(MappedFile const&) = delete;
+
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	~MappedFile()
+	{
+		close(size);
+	}
+	// endregion
+
+	bool open(spdlog::filename_t const& filename, size_t length)
+	{
+		size = length;
+#ifdef _WIN32
+#ifdef SPDLOG_WCHAR_FILENAMES
+		file = CreateFileW(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+			CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+		file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+			CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		created_ = true;
+		// mapping extends the file to its size
+		const auto size64 = static_cast<uint64_t>(length);
+		mapping = CreateFileMappingW(
+			file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFu), nullptr);
+		if (mapping == nullptr)
+		{
+			return false;
+		}
+		data_ = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, length));
+		return data_ != nullptr;
+#else
+		// never reuses a file, it may be a segment of another log
+		fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+		if (fd < 0)
+		{
+			return false;
+		}
+		created_ = true;
+#if defined(__linux__)
+		if (posix_fallocate(fd, 0, static_cast<off_t>(length)) != 0)
+#else
+		if (ftruncate(fd, static_cast<off_t>(length)) != 0)
+#endif
+		{
+			return false;
+		}
+		int flags = MAP_SHARED;
+#if defined(__linux__)
+		// faults the pages in here, on the rotation thread, instead of in the loggers
+		flags |= MAP_POPULATE;
+#endif
+		void* address = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, fd, 0);
+		if (address == MAP_FAILED)
+		{
+			return false;
+		}
+		data_ = static_cast<char*>(address);
+		return true;
+#endif
+	}
+
+	char* data() const
+	{
+		return data_;
+	}
+
+	/**
+	 * \return whether [open] created the file, even if it failed to map it later
+	 */
+	bool created() const
+	{
+		return created_;
+	}
+
+	void flush(size_t length) const
+	{
+		if (data_ == nullptr || length == 0)
+		{
+			return;
+		}
+#ifdef _WIN32
+		FlushViewOfFile(data_, length);
+#else
+		msync(data_, length, MS_ASYNC);
+#endif
+	}
+
+	void close(size_t length)
+	{
+#ifdef _WIN32
+		if (data_ != nullptr)
+		{
+			UnmapViewOfFile(data_);
+		}
+		if (mapping != nullptr)
+		{
+			CloseHandle(mapping);
+		}
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER position;
+			position.QuadPart = static_cast<LONGLONG>(length);
+			if (SetFilePointerEx(file, position, nullptr, FILE_BEGIN))
+			{
+				SetEndOfFile(file);
+			}
+			CloseHandle(file);
+		}
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (data_ != nullptr)
+		{
+			munmap(data_, size);
+		}
+		if (fd >= 0)
+		{
+			if (ftruncate(fd, static_cast<off_t>(length)) != 0)
+			{
+				// the segment keeps its zero tail
+			}
+			::close(fd);
+		}
+		fd = -1;
+#endif
+		data_ = nullptr;
+	}
+};
+
+struct MappedLog::Segment
+{
+	spdlog::filename_t filename;
+	MappedFile file;
+	char* data = nullptr;
+	size_t size = 0;
+
+	std::atomic<size_t> reserved{0};
+	// offset of the record which didn't fit, the segment ends there
+	std::atomic<size_t> end{0};
+	// bytes copied by writers, the segment is complete once they reach its length
+	std::atomic<size_t> committed{0};
+
+	/**
+	 * \brief Makes further reservations fail and waits for the writers of earlier ones to finish their copy.
+	 */
+	void seal()
+	{
+		const size_t sealed = reserved.fetch_add(size + 1, std::memory_order_acq_rel);
+		// a writer whose record didn't fit may not have stored [end] yet
+		while (committed.load(std::memory_order_acquire) != (std::min)(sealed, end.load(std::memory_order_acquire)))
+		{
+			std::this_thread::yield();
+		}
+		end.store((std::min)(sealed, end.load(std::memory_order_relaxed)), std::memory_order_release);
+	}
+};
+
+MappedLog::MappedLog(spdlog::filename_t base_filename, size_t segment_size, size_t max_files, std::string segment_header)
+	: base_filename(std::move(base_filename))
+	, segment_size(segment_size)
+	, max_files(max_files)
+	, segment_header(std::move(segment_header))
+{
+	// numbering continues after the segments of earlier logs, which count against [max_files] as well
+	for (size_t index : existing_segments(basename(), extension()))
+	{
+		closed_files.push_back(segment_filename(index));
+		next_index = index + 1;
+	}
+	remove_old_files(1);
+	current = open_segment();
+	active.store(current.get(), std::memory_order_release);
+	rotation_thread = std::thread([this] { rotation_proc(); });
+}
+
+MappedLog::~MappedLog()
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		stopping = true;
+	}
+	rotation_var.notify_all();
+	rotation_thread.join();
+}
+
+spdlog::filename_t MappedLog::basename() const
+{
+	return std::get<0>(spdlog::details::file_helper::split_by_extension(base_filename));
+}
+
+spdlog::filename_t MappedLog::extension() const
+{
+	return std::get<1>(spdlog::details::file_helper::split_by_extension(base_filename));
+}
+
+spdlog::filename_t MappedLog::segment_filename(size_t index) const
+{
+	return fmt::format(SPDLOG_FILENAME_T("{}.{}{}"), basename(), index, extension());
+}
+
+void MappedLog::remove_old_files(size_t open_files)
+{
+	while (max_files != 0 && !closed_files.empty() && closed_files.size() + open_files > max_files)
+	{
+		spdlog::details::os::remove(closed_files.front());
+		closed_files.pop_front();
+	}
+}
+
+std::unique_ptr<MappedLog::Segment> MappedLog::open_segment()
+{
+	auto segment = std::make_unique<Segment>();
+	// skips segments another log created since
+	while (spdlog::details::os::path_exists(segment_filename(next_index)))
+	{
+		++next_index;
+	}
+	segment->filename = segment_filename(next_index);
+	if (!segment->file.open(segment->filename, segment_size))
+	{
+		const bool created = segment->file.created();
+		segment->file.close(0);
+		if (created)
+		{
+			spdlog::details::os::remove(segment->filename);
+		}
+		return nullptr;
+	}
+	++next_index;
+	// pages of a shared mapping become writable on their first write, which would otherwise fault in the writers
+	constexpr size_t page_size = 4096;
+	for (size_t offset = 0; offset < segment_size; offset += page_size)
+	{
+		segment->file.data()[offset] = 0;
+	}
+	segment->data = segment->file.data();
+	segment->size = segment_size;
+	memcpy(segment->data, segment_header.data(), segment_header.size());
+	segment->reserved.store(segment_header.size());
+	segment->committed.store(segment_header.size());
+	segment->end.store(segment_size);
+	return segment;
+}
+
+void MappedLog::close_segment(Segment& segment)
+{
+	segment.seal();
+	segment.file.close(segment.end.load(std::memory_order_acquire));
+}
+
+bool MappedLog::append(size_t size, function_ref<void(char* data)> writer)
+{
+	if (size > segment_size - segment_header.size())
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		Segment* segment = active.load(std::memory_order_acquire);
+		if (segment != nullptr)
+		{
+			const size_t offset = segment->reserved.fetch_add(size, std::memory_order_relaxed);
+			if (offset + size <= segment->size)
+			{
+				writer(segment->data + offset);
+				segment->committed.fetch_add(size, std::memory_order_release);
+				return true;
+			}
+			if (offset < segment->size)
+			{
+				segment->end.store(offset, std::memory_order_release);
+			}
+		}
+		if (!switch_segment(segment))
+		{
+			return false;
+		}
+	}
+}
+
+bool MappedLog::switch_segment(Segment* full)
+{
+	std::unique_lock<decltype(lock)> guard(lock);
+	if (active.load(std::memory_order_acquire) != full)
+	{
+		return true;
+	}
+	if (spare == nullptr)
+	{
+		// the rotation thread keeps a spare segment ready, getting here means it is behind or can't open files
+		if (open_failed)
+		{
+			return false;
+		}
+		rotation_var.notify_all();
+		spare_var.wait(guard, [this] { return spare != nullptr || open_failed || stopping; });
+		if (spare == nullptr || stopping)
+		{
+			return false;
+		}
+	}
+	if (full != nullptr)
+	{
+		retired.push_back(std::move(current));
+	}
+	current = std::move(spare);
+	active.store(current.get(), std::memory_order_release);
+	rotation_var.notify_all();
+	return true;
+}
+
+void MappedLog::rotation_proc()
+{
+	std::unique_lock<decltype(lock)> guard(lock);
+	while (true)
+	{
+		if (spare == nullptr && !stopping)
+		{
+			guard.unlock();
+			auto segment = open_segment();
+			guard.lock();
+			spare = std::move(segment);
+			open_failed = spare == nullptr;
+			spare_var.notify_all();
+		}
+
+		// the lock is released while segments are closed, a stop requested meanwhile is handled by the next pass
+		const bool stop = stopping;
+		if (!retired.empty() || stop)
+		{
+			auto segments = std::move(retired);
+			retired.clear();
+			if (stop)
+			{
+				segments.push_back(std::move(current));
+				active.store(nullptr, std::memory_order_release);
+			}
+			guard.unlock();
+			for (auto& segment : segments)
+			{
+				if (segment != nullptr)
+				{
+					close_segment(*segment);
+				}
+			}
+			guard.lock();
+			for (auto& segment : segments)
+			{
+				if (segment != nullptr)
+				{
+					closed_files.push_back(segment->filename);
+					closed.push_back(std::move(segment));
+				}
+			}
+			remove_old_files(stop ? 0 : 1);
+		}
+
+		if (stop)
+		{
+			if (spare != nullptr)
+			{
+				spare->file.close(0);
+				spdlog::details::os::remove(spare->filename);
+				spare.reset();
+			}
+			spare_var.notify_all();
+			return;
+		}
+		// retries opening a segment which failed after a while
+		rotation_var.wait_for(guard, std::chrono::seconds(1),
+			[this] { return stopping || !retired.empty() || (spare == nullptr && !open_failed); });
+		open_failed = false;
+	}
+}
+
+void MappedLog::flush()
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	if (current != nullptr)
+	{
+		current->file.flush((std::min)(current->reserved.load(), current->size));
+	}
+}
+
+spdlog::filename_t MappedLog::filename()
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	return current != nullptr ? current->filename : spdlog::filename_t{};
+}
+}	 // namespace util
+}	 // namespace rd
@@ -0,0 +1,132 @@
+#ifndef RD_CPP_MAPPEDLOG_H
+#define RD_CPP_MAPPEDLOG_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "util/function_ref.h"
+
+#include "spdlog/common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Log of records appended to memory-mapped, preallocated file segments by any number of threads.
+ *
+ * \details A writer reserves room in the active segment with one atomic add, fills it in place and counts it as
+ * committed with another, so writers don't serialize on a mutex or a write call. A background thread prepares
+ * the next segment ahead of time and, once a segment is full and its writers are done, truncates it to the written
+ * length and closes it. Segments are named like [rotating_file_sink] files ("trace.3.log"), numbered upwards after
+ * the highest segment already in the directory, each starting with [segment_header]; at most [max_files] of them
+ * are kept, segments of earlier logs included, 0 keeps all. Records are visible
+ * to readers of the file right away, the file of the active segment ends with zeros up to the segment size until
+ * it is closed.
+ */
+class RD_FRAMEWORK_API MappedLog
+{
+public:
+	static constexpr size_t DEFAULT_SEGMENT_SIZE = 64u << 20;
+
+	static constexpr size_t DEFAULT_MAX_FILES = 8;
+
+	struct Segment;
+
+private:
+	class MappedFile;
+
+	const spdlog::filename_t base_filename;
+	const size_t segment_size;
+	const size_t max_files;
+	const std::string segment_header;
+
+	std::atomic<Segment*> active{nullptr};
+
+	std::mutex lock;
+	std::condition_variable rotation_var;
+	std::condition_variable spare_var;
+	std::unique_ptr<Segment> spare;
+	std::deque<std::unique_ptr<Segment>> retired;
+	std::deque<spdlog::filename_t> closed_files;
+	// a writer may still hold a pointer to a closed segment until it sees the segment full, they live as long as the log
+	std::deque<std::unique_ptr<Segment>> closed;
+	std::unique_ptr<Segment> current;
+	size_t next_index = 1;
+	bool open_failed = false;
+	bool stopping = false;
+
+	std::thread rotation_thread;
+
+	spdlog::filename_t basename() const;
+
+	spdlog::filename_t extension() const;
+
+	spdlog::filename_t segment_filename(size_t index) const;
+
+	/**
+	 * \brief Deletes the oldest closed segments beyond [max_files], counting [open_files] segments still written to.
+	 */
+	void remove_old_files(size_t open_files);
+
+	std::unique_ptr<Segment> open_segment();
+
+	void close_segment(Segment& segment);
+
+	/**
+	 * \brief Replaces the [full] segment by the spare one, false if there is none to write the record to.
+	 */
+	bool switch_segment(Segment* full);
+
+	void rotation_proc();
+
+public:
+	// region ctor/dtor
+
+	explicit MappedLog(spdlog::filename_t base_filename, size_t segment_size = DEFAULT_SEGMENT_SIZE,
+		size_t max_files = DEFAULT_MAX_FILES,
+		std::string segment_header = {});
+
+	MappedLog(MappedLog const&) = delete;
+
+	MappedLog& operator=(MappedLog const&) = delete;
+
+	~MappedLog();
+	// endregion
+
+	/**
+	 * \brief Reserves [size] bytes in the active segment and lets [writer] fill them, possibly concurrently with other
+	 * writers. False if the record was dropped: it doesn't fit in a segment or no segment could be opened.
+	 */
+	bool append(size_t size, function_ref<void(char* data)> writer);
+
+	/**
+	 * \brief Schedules write-back of the active segment, records are already visible to readers of the file.
+	 */
+	void flush();
+
+	/**
+	 * \brief File of the active segment.
+	 */
+	spdlog::filename_t filename();
+};
+}	 // namespace util
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_MAPPEDLOG_H
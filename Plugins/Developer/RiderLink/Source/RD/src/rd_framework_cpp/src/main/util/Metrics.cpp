@@ -0,0 +1,252 @@
+#include "Metrics.h"
+
+#include "std/to_string.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <condition_variable>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace rd
+{
+namespace util
+{
+namespace
+{
+std::atomic<size_t> next_shard{0};
+
+size_t thread_shard()
+{
+	thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % Counter::SHARDS;
+	return shard;
+}
+
+// index of the highest set bit of a non-zero value
+size_t highest_bit(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+	{
+		return index + 32;
+	}
+	_BitScanReverse(&index, static_cast<unsigned long>(value));
+	return index;
+#else
+	return 63 - static_cast<size_t>(__builtin_clzll(value));
+#endif
+}
+}	 // namespace
+
+void Counter::add(uint64_t delta)
+{
+	shards[thread_shard()].value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+uint64_t Counter::get() const
+{
+	uint64_t total = 0;
+	for (auto const& shard : shards)
+	{
+		total += shard.value.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+size_t Histogram::bucket_of(uint64_t value)
+{
+	if (value < SUB_BUCKETS)
+	{
+		return static_cast<size_t>(value);
+	}
+	const size_t shift = highest_bit(value) - SUB_BUCKET_BITS;
+	return (shift + 1) * SUB_BUCKETS + static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t Histogram::highest_value_of(size_t bucket)
+{
+	if (bucket < SUB_BUCKETS)
+	{
+		return bucket;
+	}
+	const size_t shift = bucket / SUB_BUCKETS - 1;
+	const uint64_t lowest = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+	return lowest + ((uint64_t{1} << shift) - 1);
+}
+
+void Histogram::record(uint64_t value)
+{
+	buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::get_count() const
+{
+	return count.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::get_sum() const
+{
+	return sum.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::value_at_percentile(double percentile) const
+{
+	// counts of buckets and the total are read separately, the total is taken from the buckets
+	uint64_t total = 0;
+	for (auto const& bucket : buckets)
+	{
+		total += bucket.load(std::memory_order_relaxed);
+	}
+	if (total == 0)
+	{
+		return 0;
+	}
+	const double target = (std::max)(1.0, percentile / 100.0 * static_cast<double>(total));
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKETS; ++i)
+	{
+		seen += buckets[i].load(std::memory_order_relaxed);
+		if (static_cast<double>(seen) >= target)
+		{
+			return highest_value_of(i);
+		}
+	}
+	return highest_value_of(BUCKETS - 1);
+}
+
+void MetricsSnapshot::add(std::string const& name, double value)
+{
+	values[name] = value;
+}
+
+void MetricsSnapshot::add(std::string const& name, Histogram const& histogram)
+{
+	add(name + ".count", static_cast<double>(histogram.get_count()));
+	add(name + ".sum", static_cast<double>(histogram.get_sum()));
+	add(name + ".p50", static_cast<double>(histogram.value_at_percentile(50)));
+	add(name + ".p90", static_cast<double>(histogram.value_at_percentile(90)));
+	add(name + ".p99", static_cast<double>(histogram.value_at_percentile(99)));
+	add(name + ".max", static_cast<double>(histogram.value_at_percentile(100)));
+}
+
+std::map<std::string, double> const& MetricsSnapshot::get_values() const
+{
+	return values;
+}
+
+double MetricsSnapshot::get(std::string const& name, double fallback) const
+{
+	auto it = values.find(name);
+	return it == values.end() ? fallback : it->second;
+}
+
+std::string MetricsSnapshot::to_json() const
+{
+	std::string json = "{";
+	for (auto const& it : values)
+	{
+		if (json.size() > 1)
+		{
+			json += ",";
+		}
+		json += "\"";
+		for (char c : it.first)
+		{
+			if (c == '"' || c == '\\')
+			{
+				json += '\\';
+			}
+			json += c;
+		}
+		json += fmt::format("\":{}", it.second);
+	}
+	json += "}";
+	return json;
+}
+
+std::atomic<bool> MetricsRegistry::enabled{false};
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+	static MetricsRegistry registry;
+	return registry;
+}
+
+void MetricsRegistry::add_source(Lifetime lifetime, Source source)
+{
+	uint64_t key;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		key = next_source++;
+		sources.emplace(key, std::move(source));
+	}
+	lifetime->add_action([this, key] {
+		std::lock_guard<decltype(lock)> guard(lock);
+		sources.erase(key);
+	});
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const
+{
+	MetricsSnapshot snapshot;
+	std::lock_guard<decltype(lock)> guard(lock);
+	for (auto const& it : sources)
+	{
+		it.second(snapshot);
+	}
+	return snapshot;
+}
+
+void MetricsRegistry::publish(Lifetime lifetime, IScheduler* scheduler, std::chrono::milliseconds period,
+	std::function<void(std::wstring json)> publisher) const
+{
+	struct Publication
+	{
+		std::mutex lock;
+		std::condition_variable var;
+		bool stopped = false;
+		std::thread thread;
+	};
+
+	auto publication = std::make_shared<Publication>();
+	publication->thread = std::thread([this, publication, lifetime, scheduler, period, publisher] {
+		std::unique_lock<decltype(publication->lock)> guard(publication->lock);
+		while (!publication->var.wait_for(guard, period, [&publication] { return publication->stopped; }))
+		{
+			guard.unlock();
+			std::wstring json = rd::to_wstring(snapshot().to_json());
+			scheduler->queue([lifetime, publisher, json]() mutable {
+				if (!lifetime->is_terminated())
+				{
+					publisher(std::move(json));
+				}
+			});
+			guard.lock();
+		}
+	});
+	if (lifetime->is_eternal())
+	{
+		publication->thread.detach();
+		return;
+	}
+	lifetime->add_action([publication] {
+		{
+			std::lock_guard<decltype(publication->lock)> guard(publication->lock);
+			publication->stopped = true;
+		}
+		publication->var.notify_all();
+		publication->thread.join();
+	});
+}
+}	 // namespace util
+}	 // namespace rd
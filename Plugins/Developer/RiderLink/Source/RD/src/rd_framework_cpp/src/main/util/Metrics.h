@@ -0,0 +1,175 @@
+#ifndef RD_CPP_METRICS_H
+#define RD_CPP_METRICS_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#pragma warning(disable:4324)
+#endif
+
+#include "lifetime/Lifetime.h"
+#include "scheduler/base/IScheduler.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Monotonic counter updated from many threads, with a slot per thread (up to [SHARDS]) so that updates
+ * don't contend on one cache line.
+ */
+class RD_FRAMEWORK_API Counter
+{
+public:
+	static constexpr size_t SHARDS = 16;
+
+private:
+	struct alignas(64) Shard
+	{
+		std::atomic<uint64_t> value{0};
+	};
+
+	std::array<Shard, SHARDS> shards;
+
+public:
+	void add(uint64_t delta = 1);
+
+	uint64_t get() const;
+};
+
+/**
+ * \brief Distribution of non-negative values in log-linear buckets, like HdrHistogram: values below [SUB_BUCKETS]
+ * are exact, larger ones fall into [SUB_BUCKETS] buckets per power of two, within 1/[SUB_BUCKETS] of their value.
+ */
+class RD_FRAMEWORK_API Histogram
+{
+public:
+	static constexpr size_t SUB_BUCKET_BITS = 3;
+	static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+	static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+	std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+	std::atomic<uint64_t> count{0};
+	std::atomic<uint64_t> sum{0};
+
+public:
+	static size_t bucket_of(uint64_t value);
+
+	/**
+	 * \brief Largest value which falls into [bucket].
+	 */
+	static uint64_t highest_value_of(size_t bucket);
+
+	void record(uint64_t value);
+
+	uint64_t get_count() const;
+
+	uint64_t get_sum() const;
+
+	/**
+	 * \brief Value at or below which [percentile] percent of the recorded values are, up to bucket precision.
+	 */
+	uint64_t value_at_percentile(double percentile) const;
+};
+
+/**
+ * \brief Values of all metrics at one moment, by name. Counters are cumulative, rates are differences between two
+ * snapshots.
+ */
+class RD_FRAMEWORK_API MetricsSnapshot
+{
+	std::map<std::string, double> values;
+
+public:
+	void add(std::string const& name, double value);
+
+	/**
+	 * \brief Adds count, sum, p50, p90, p99 and max of [histogram] as "[name].count" etc.
+	 */
+	void add(std::string const& name, Histogram const& histogram);
+
+	std::map<std::string, double> const& get_values() const;
+
+	/**
+	 * \brief Value of the metric [name], [fallback] if there is none.
+	 */
+	double get(std::string const& name, double fallback = 0) const;
+
+	/**
+	 * \brief One JSON object of all values, keys in name order.
+	 */
+	std::string to_json() const;
+};
+
+/**
+ * \brief Process-wide registry of metric sources, pulled on [snapshot].
+ *
+ * \details Components own their counters and histograms and register a source reporting them, and gauges such as queue
+ * depths, for as long as they live. Hot paths update counters only when [enabled] is set, which costs them one
+ * relaxed load otherwise; gauges are read when a snapshot is taken, so they cost nothing in between.
+ */
+class RD_FRAMEWORK_API MetricsRegistry
+{
+public:
+	using Source = std::function<void(MetricsSnapshot& snapshot)>;
+
+	static std::atomic<bool> enabled;
+
+private:
+	mutable std::mutex lock;
+	std::map<uint64_t, Source> sources;
+	uint64_t next_source = 0;
+
+public:
+	static MetricsRegistry& instance();
+
+	static bool is_enabled()
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Reports [source] in snapshots until [lifetime] is terminated. Sources are called under the registry's
+	 * lock, termination waits for a snapshot in progress.
+	 */
+	void add_source(Lifetime lifetime, Source source);
+
+	MetricsSnapshot snapshot() const;
+
+	/**
+	 * \brief Passes the JSON of a snapshot to [publisher] every [period] until [lifetime] is terminated, on [scheduler].
+	 */
+	void publish(Lifetime lifetime, IScheduler* scheduler, std::chrono::milliseconds period,
+		std::function<void(std::wstring json)> publisher) const;
+
+	/**
+	 * \brief Sets [property], e.g. an RdProperty<std::wstring> bound on [scheduler], to the JSON of a snapshot every
+	 * [period] until [lifetime] is terminated. The IDE side displays it by binding a string property at the same
+	 * location.
+	 */
+	template <typename P>
+	void publish(Lifetime lifetime, P const& property, IScheduler* scheduler, std::chrono::milliseconds period) const
+	{
+		publish(lifetime, scheduler, period, [&property](std::wstring json) { property.set(std::move(json)); });
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_METRICS_H
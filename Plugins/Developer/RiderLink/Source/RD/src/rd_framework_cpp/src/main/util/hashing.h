@@ -18,9 +18,14 @@ constexpr constexpr_hash_t DEFAULT_HASH = 19;
 constexpr constexpr_hash_t HASH_FACTOR = 31;
 
 // PLEASE DO NOT CHANGE IT!!! IT'S EXACTLY THE SAME ON C# SIDE
+// iterative, so long names don't hit the constexpr recursion depth limit
 constexpr hash_t hashImpl(constexpr_hash_t initial, char const* begin, char const* end)
 {
-	return (begin == end) ? initial : hashImpl(initial * HASH_FACTOR + *begin, begin + 1, end);
+	for (; begin != end; ++begin)
+	{
+		initial = initial * HASH_FACTOR + *begin;
+	}
+	return static_cast<hash_t>(initial);
 }
 
 /*template<size_t N>
@@ -30,7 +35,35 @@ constexpr hash_t getPlatformIndependentHash(char const (&that)[N], constexpr_has
 
 constexpr hash_t getPlatformIndependentHash(string_view that, constexpr_hash_t initial = DEFAULT_HASH)
 {
-	return static_cast<hash_t>(hashImpl(initial, &that[0], &that[that.length() - 1] + 1));
+	return hashImpl(initial, that.data(), that.data() + that.length());
+}
+
+/**
+ * \brief Effect of hashing a fixed string on top of any initial value: the result is initial * factor + addend.
+ */
+struct hash_suffix
+{
+	constexpr_hash_t factor;
+	constexpr_hash_t addend;
+};
+
+/**
+ * \return suffix equivalent to hashing [initial] followed by [that]
+ */
+constexpr hash_suffix getPlatformIndependentHashSuffix(string_view that, hash_suffix initial = hash_suffix{1, 0})
+{
+	hash_suffix res = initial;
+	for (char c : that)
+	{
+		res.factor *= HASH_FACTOR;
+		res.addend = res.addend * HASH_FACTOR + c;
+	}
+	return res;
+}
+
+constexpr hash_t getPlatformIndependentHash(hash_suffix const& that, constexpr_hash_t initial = DEFAULT_HASH)
+{
+	return static_cast<hash_t>(initial * that.factor + that.addend);
 }
 
 constexpr hash_t getPlatformIndependentHash(int32_t const& that, constexpr_hash_t initial = DEFAULT_HASH)
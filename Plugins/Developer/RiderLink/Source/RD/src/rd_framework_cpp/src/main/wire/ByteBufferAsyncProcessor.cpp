@@ -7,7 +7,10 @@
 
 namespace rd
 {
-size_t ByteBufferAsyncProcessor::INITIAL_CAPACITY = 1024 * 1024;
+size_t ByteBufferAsyncProcessor::INITIAL_CAPACITY = 1024;
+
+constexpr size_t ByteBufferAsyncProcessor::LANES;
+constexpr size_t ByteBufferAsyncProcessor::DEFAULT_LANE;
 
 std::shared_ptr<spdlog::logger> ByteBufferAsyncProcessor::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("byteBufferLog", spdlog::color_mode::automatic);
@@ -16,7 +19,7 @@ ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(
 	std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor)
 	: id(std::move(id)), processor(std::move(processor))
 {
-	data.reserve(INITIAL_CAPACITY);
+	data[DEFAULT_LANE].reserve(INITIAL_CAPACITY);
 }
 
 void ByteBufferAsyncProcessor::cleanup0()
@@ -29,6 +32,7 @@ void ByteBufferAsyncProcessor::cleanup0()
 	// TO-DO clean data
 
 	cv.notify_all();
+	space_cv.notify_all();
 }
 
 bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set, string_view action)
@@ -51,6 +55,7 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 		state = state_to_set;
 	}
 	cv.notify_all();
+	space_cv.notify_all();
 
 	std::future_status status = async_future.wait_for(timeout);
 
@@ -67,13 +72,76 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 	return success;
 }
 
-void ByteBufferAsyncProcessor::add_data(std::vector<Buffer::ByteArray>&& new_data)
+bool ByteBufferAsyncProcessor::has_data() const
+{
+	for (auto const& lane : data)
+	{
+		if (!lane.empty())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void ByteBufferAsyncProcessor::add_data()
 {
 	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
-	std::move(new_data.begin(), new_data.end(), std::back_inserter(queue));
-	//		for (auto &&item : new_data) {
-	//			queue.emplace(std::move(item));
-	//		}
+	for (size_t lane = 0; lane < LANES; ++lane)
+	{
+		std::move(data[lane].begin(), data[lane].end(), std::back_inserter(queues[lane]));
+		data[lane].clear();
+	}
+	new_data_lane = LANES;
+}
+
+size_t ByteBufferAsyncProcessor::next_lane()
+{
+	for (int attempt = 0; attempt < 2; ++attempt)
+	{
+		bool any = false;
+		for (size_t lane = 0; lane < LANES; ++lane)
+		{
+			if (!queues[lane].empty())
+			{
+				any = true;
+				if (lane_credits[lane] > 0)
+				{
+					return lane;
+				}
+			}
+		}
+		if (!any)
+		{
+			break;
+		}
+		// every lane with data has used up its turn
+		lane_credits = lane_weights;
+	}
+	return LANES;
+}
+
+sequence_number_t ByteBufferAsyncProcessor::drop_acknowledged()
+{
+	const sequence_number_t acknowledged = acknowledged_seqn.load();
+	while (current_seqn <= acknowledged && !pending_queue.empty())
+	{
+		pending_bytes -= pending_queue.front().size();
+		--pending_packages;
+		pending_queue.pop_front();
+		++current_seqn;
+	}
+	return acknowledged;
+}
+
+bool ByteBufferAsyncProcessor::window_open() const
+{
+	return window_bytes == 0 || pending_queue.empty() || pending_bytes < window_bytes;
+}
+
+bool ByteBufferAsyncProcessor::ready_to_process() const
+{
+	return has_data() || (window_full && acknowledged_seqn.load() > window_ack_seqn);
 }
 
 bool ByteBufferAsyncProcessor::reprocess()
@@ -88,11 +156,7 @@ bool ByteBufferAsyncProcessor::reprocess()
 
 		logger->debug("{}: reprocessing waited for main processing", id);
 
-		while (current_seqn <= acknowledged_seqn)
-		{
-			pending_queue.pop_front();
-			++current_seqn;
-		}
+		drop_acknowledged();
 		for (int i = 0; i < pending_queue.size(); ++i)
 		{
 			auto const& item = pending_queue[i];
@@ -105,8 +169,9 @@ bool ByteBufferAsyncProcessor::reprocess()
 	return true;
 }
 
-void ByteBufferAsyncProcessor::process()
+bool ByteBufferAsyncProcessor::process()
 {
+	bool yielded = false;
 	{
 		std::lock_guard<decltype(queue_lock)> guard(queue_lock);
 		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
@@ -114,9 +179,39 @@ void ByteBufferAsyncProcessor::process()
 
 		logger->debug("{}: processing started", id);
 
-		while (!queue.empty() && processor(queue.front(), max_sent_seqn + 1))
+		window_full = false;
+		drop_acknowledged();
+		for (size_t lane = next_lane(); lane < LANES; lane = next_lane())
 		{
+			const size_t urgent = new_data_lane.load(std::memory_order_relaxed);
+			if (urgent < lane && lane_credits[urgent] > 0)
+			{
+				yielded = true;
+				break;
+			}
+			if (!window_open())
+			{
+				const sequence_number_t acknowledged = drop_acknowledged();
+				if (!window_open())
+				{
+					logger->debug("{}: window of {} bytes is full", id, window_bytes);
+					window_full = true;
+					window_ack_seqn = acknowledged;
+					break;
+				}
+			}
+			auto& queue = queues[lane];
+			if (!processor(queue.front(), max_sent_seqn + 1))
+			{
+				break;
+			}
 			++max_sent_seqn;
+			--lane_credits[lane];
+			const size_t size = queue.front().size();
+			queued_bytes -= size;
+			--queued_packages;
+			pending_bytes += size;
+			++pending_packages;
 			pending_queue.push_back(std::move(queue.front()));
 			queue.pop_front();
 		}
@@ -124,6 +219,12 @@ void ByteBufferAsyncProcessor::process()
 	processing_cv.notify_all();
 
 	cv.notify_all();
+	{
+		// producers check for room under [lock]
+		std::lock_guard<decltype(lock)> guard(lock);
+	}
+	space_cv.notify_all();
+	return yielded;
 }
 
 void ByteBufferAsyncProcessor::ThreadProc()
@@ -131,6 +232,7 @@ void ByteBufferAsyncProcessor::ThreadProc()
 	rd::util::set_thread_name(id.empty() ? "ByteBufferAsyncProcessor Thread" : id.c_str());
 	async_thread_id = std::this_thread::get_id();
 
+	bool yielded = false;
 	while (true)
 	{
 		{
@@ -141,7 +243,7 @@ void ByteBufferAsyncProcessor::ThreadProc()
 				return;
 			}
 
-			while (data.empty() || interrupt_balance != 0)
+			while ((!yielded && !ready_to_process()) || interrupt_balance != 0)
 			{
 				if (state >= StateKind::Stopping)
 				{
@@ -156,13 +258,13 @@ void ByteBufferAsyncProcessor::ThreadProc()
 					return;
 				}
 			}
-			add_data(std::move(data));
-			data.clear();
+			yielded = false;
+			add_data();
 		}
 
 		try
 		{
-			process();
+			yielded = process();
 		}
 		catch (std::exception const& e)
 		{
@@ -198,20 +300,95 @@ bool ByteBufferAsyncProcessor::terminate(time_t timeout)
 	return terminate0(timeout, StateKind::Terminating, "TERMINATE");
 }
 
-void ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data)
+bool ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data, size_t lane)
 {
+	RD_ASSERT_MSG(lane < LANES, "lane must be less than " + std::to_string(LANES) + ", got " + std::to_string(lane));
+	const size_t size = new_data.size();
 	{
-		std::lock_guard<decltype(lock)> guard(lock);
+		std::unique_lock<decltype(lock)> guard(lock);
 
 		if (state >= StateKind::Stopping)
 		{
-			return;
+			return false;
+		}
+		// a single package larger than the cap still goes through alone
+		auto has_room = [this, size] {
+			return max_queued_bytes == 0 || queued_packages == 0 || queued_bytes + size <= max_queued_bytes;
+		};
+		if (!has_room())
+		{
+			if (overflow_policies[lane] == OverflowPolicy::Drop)
+			{
+				++dropped_packages;
+				dropped_bytes += size;
+				logger->trace("{}: dropped package of {} bytes, {} bytes are queued", id, size, queued_bytes.load());
+				return false;
+			}
+			++blocked_puts;
+			space_cv.wait(guard, [this, &has_room] { return state >= StateKind::Stopping || has_room(); });
+			if (state >= StateKind::Stopping)
+			{
+				return false;
+			}
 		}
-		data.emplace_back(std::move(new_data));
+		data[lane].emplace_back(std::move(new_data));
+		queued_bytes += size;
+		++queued_packages;
+		if (lane < new_data_lane.load(std::memory_order_relaxed))
+		{
+			new_data_lane.store(lane, std::memory_order_relaxed);
+		}
+	}
+	cv.notify_all();
+	return true;
+}
+
+void ByteBufferAsyncProcessor::set_lane_weight(size_t lane, uint32_t weight)
+{
+	RD_ASSERT_MSG(lane < LANES, "lane must be less than " + std::to_string(LANES) + ", got " + std::to_string(lane));
+	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+	lane_weights[lane] = (std::max)(weight, 1u);
+	lane_credits[lane] = lane_weights[lane];
+}
+
+void ByteBufferAsyncProcessor::set_window(size_t bytes)
+{
+	{
+		std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+		window_bytes = bytes;
 	}
 	cv.notify_all();
 }
 
+void ByteBufferAsyncProcessor::set_max_queued_bytes(size_t bytes)
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		max_queued_bytes = bytes;
+	}
+	space_cv.notify_all();
+}
+
+void ByteBufferAsyncProcessor::set_overflow_policy(size_t lane, OverflowPolicy policy)
+{
+	RD_ASSERT_MSG(lane < LANES, "lane must be less than " + std::to_string(LANES) + ", got " + std::to_string(lane));
+	std::lock_guard<decltype(lock)> guard(lock);
+	overflow_policies[lane] = policy;
+}
+
+ByteBufferAsyncProcessor::Stats ByteBufferAsyncProcessor::get_stats() const
+{
+	Stats stats;
+	stats.queued_packages = queued_packages;
+	stats.queued_bytes = queued_bytes;
+	stats.pending_packages = pending_packages;
+	stats.pending_bytes = pending_bytes;
+	stats.dropped_packages = dropped_packages;
+	stats.dropped_bytes = dropped_bytes;
+	stats.blocked_puts = blocked_puts;
+	return stats;
+}
+
 void ByteBufferAsyncProcessor::pause(const std::string& reason)
 {
 	std::lock_guard<decltype(lock)> guard(lock);
@@ -247,17 +424,22 @@ void ByteBufferAsyncProcessor::resume()
 
 void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
 {
-	std::lock_guard<decltype(lock)> guard(lock);
-
-	if (seqn > acknowledged_seqn)
-	{
-		logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
-		acknowledged_seqn = seqn;
-	}
-	else
 	{
-		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
+		std::lock_guard<decltype(lock)> guard(lock);
+
+		if (seqn > acknowledged_seqn)
+		{
+			logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
+			acknowledged_seqn = seqn;
+		}
+		else
+		{
+			logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn.load());
+			return;
+		}
 	}
+	// wakes up sending stopped on a full window
+	cv.notify_all();
 }
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state)
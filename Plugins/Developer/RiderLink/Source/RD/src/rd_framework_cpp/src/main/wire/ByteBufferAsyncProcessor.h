@@ -9,6 +9,8 @@
 #include "protocol/Buffer.h"
 #include "spdlog/spdlog.h"
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <mutex>
@@ -34,6 +36,41 @@ public:
 		Terminated
 	};
 
+	/**
+	 * \brief Number of send queues, lane 0 has the highest priority.
+	 */
+	static constexpr size_t LANES = 3;
+
+	static constexpr size_t DEFAULT_LANE = 1;
+
+	/**
+	 * \brief What [put] does with a package which doesn't fit into the byte cap.
+	 */
+	enum class OverflowPolicy
+	{
+		// wait until the sender makes room or the processor stops
+		Block,
+		// discard the package, for streams whose messages may be lost
+		Drop
+	};
+
+	/**
+	 * \brief Memory accounting snapshot, see [get_stats].
+	 */
+	struct Stats
+	{
+		// put but not sent yet
+		size_t queued_packages = 0;
+		size_t queued_bytes = 0;
+		// sent but not acknowledged yet
+		size_t pending_packages = 0;
+		size_t pending_bytes = 0;
+		size_t dropped_packages = 0;
+		size_t dropped_bytes = 0;
+		// puts which had to wait for room
+		size_t blocked_puts = 0;
+	};
+
 private:
 	using time_t = std::chrono::milliseconds;
 
@@ -52,14 +89,39 @@ private:
 	std::thread::id async_thread_id;
 	std::future<void> async_future;
 
-	std::vector<Buffer::ByteArray> data;
+	std::array<std::vector<Buffer::ByteArray>, LANES> data;
+	// the most urgent lane which got data since it was last moved to the queues, LANES if none
+	std::atomic<size_t> new_data_lane{LANES};
+
 	std::mutex queue_lock;
-	std::deque<Buffer::ByteArray> queue{};
+	std::array<std::deque<Buffer::ByteArray>, LANES> queues{};
+	// sent but not yet acknowledged packages in order of their sequence numbers, whatever lanes they came from
 	std::deque<Buffer::ByteArray> pending_queue{};
 
+	// how many packages in a row each lane may send while lanes with lower priority are waiting
+	std::array<uint32_t, LANES> lane_weights{{16, 4, 1}};
+	std::array<uint32_t, LANES> lane_credits{{16, 4, 1}};
+
 	sequence_number_t max_sent_seqn = 0;
 	sequence_number_t current_seqn = 1;
-	sequence_number_t acknowledged_seqn = 0;
+	std::atomic<sequence_number_t> acknowledged_seqn{0};
+
+	// flow control, 0 means unlimited
+	size_t window_bytes = 0;
+	size_t max_queued_bytes = 0;
+	std::array<OverflowPolicy, LANES> overflow_policies{{OverflowPolicy::Block, OverflowPolicy::Block, OverflowPolicy::Block}};
+	std::condition_variable_any space_cv;
+	// set when sending stopped on a full window, until an acknowledgement newer than [window_ack_seqn] arrives
+	bool window_full = false;
+	sequence_number_t window_ack_seqn = 0;
+
+	std::atomic<size_t> queued_packages{0};
+	std::atomic<size_t> queued_bytes{0};
+	std::atomic<size_t> pending_bytes{0};
+	std::atomic<size_t> pending_packages{0};
+	std::atomic<size_t> dropped_packages{0};
+	std::atomic<size_t> dropped_bytes{0};
+	std::atomic<size_t> blocked_puts{0};
 
 	int32_t interrupt_balance = 0;
 	bool in_processing = false;
@@ -77,11 +139,27 @@ private:
 
 	bool terminate0(time_t timeout, StateKind state_to_set, string_view action);
 
-	void add_data(std::vector<Buffer::ByteArray>&& new_data);
+	bool has_data() const;
+
+	void add_data();
+
+	size_t next_lane();
+
+	/**
+	 * \return the acknowledged sequence number the pending queue was trimmed to
+	 */
+	sequence_number_t drop_acknowledged();
+
+	bool window_open() const;
+
+	bool ready_to_process() const;
 
 	bool reprocess();
 
-	void process();
+	/**
+	 * \return true if processing stopped early to pick up data for a lane with higher priority
+	 */
+	bool process();
 
 	void ThreadProc();
 
@@ -92,7 +170,35 @@ public:
 
 	bool terminate(time_t timeout = time_t(0) /*InfiniteDuration*/);
 
-	void put(Buffer::ByteArray new_data);
+	/**
+	 * \brief Queues [new_data] for sending in [lane]. Packages of one lane are sent in order; lanes are served by
+	 * weighted round robin, so an urgent package overtakes the backlog of lanes with lower priority.
+	 * Sequence numbers are assigned in the order packages are actually sent.
+	 * \return false if the package was dropped by the overflow policy of [lane] or because the processor is stopping
+	 */
+	bool put(Buffer::ByteArray new_data, size_t lane = DEFAULT_LANE);
+
+	/**
+	 * \brief Sets how many packages in a row [lane] may send while lanes with lower priority have data, at least 1.
+	 */
+	void set_lane_weight(size_t lane, uint32_t weight);
+
+	/**
+	 * \brief Stops sending while [bytes] of sent packages are not acknowledged, 0 to send regardless of acknowledgements.
+	 * A package is always sent if nothing is pending, however large it is.
+	 */
+	void set_window(size_t bytes);
+
+	/**
+	 * \brief Caps bytes of packages put but not yet sent, 0 for no cap. Packages over the cap are handled according
+	 * to the overflow policy of their lane. Note that nothing is sent while the processor is paused, e.g. disconnected,
+	 * so blocking producers wait for the connection.
+	 */
+	void set_max_queued_bytes(size_t bytes);
+
+	void set_overflow_policy(size_t lane, OverflowPolicy policy);
+
+	Stats get_stats() const;
 
 	void pause(const std::string& reason);
 
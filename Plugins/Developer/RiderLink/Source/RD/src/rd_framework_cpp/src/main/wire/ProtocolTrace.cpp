@@ -0,0 +1,220 @@
+#include "wire/ProtocolTrace.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace rd
+{
+namespace
+{
+constexpr char MAGIC[8] = {'R', 'D', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+// framing of [IWire::write_frame]: int32 length of the rest, id
+constexpr size_t FRAME_HEADER_SIZE = sizeof(int32_t) + sizeof(RdId::hash_t);
+
+std::string file_header()
+{
+	std::string header(ProtocolTrace::FILE_HEADER_SIZE, '\0');
+	const uint32_t version = ProtocolTrace::VERSION;
+	const uint32_t record_header_size = static_cast<uint32_t>(ProtocolTrace::RECORD_HEADER_SIZE);
+	memcpy(&header[0], MAGIC, sizeof(MAGIC));
+	memcpy(&header[8], &version, sizeof(version));
+	memcpy(&header[12], &record_header_size, sizeof(record_header_size));
+	return header;
+}
+
+template <typename T>
+T read_at(Buffer::word_t const* data)
+{
+	T value;
+	memcpy(&value, data, sizeof(T));
+	return value;
+}
+}	 // namespace
+
+ProtocolTrace::ProtocolTrace(spdlog::filename_t base_filename, size_t segment_size, size_t max_files)
+	: log(std::move(base_filename), segment_size, max_files, file_header())
+{
+}
+
+void ProtocolTrace::record(Direction direction, RdId const& id, Buffer::word_t const* payload, size_t size)
+{
+	const int64_t timestamp_ns =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	const bool written = log.append(RECORD_HEADER_SIZE + size, [&](char* data) {
+		const uint32_t payload_size = static_cast<uint32_t>(size);
+		const RdId::hash_t hash = id.get_hash();
+		memcpy(data, &payload_size, sizeof(payload_size));
+		data[4] = static_cast<char>(direction);
+		data[5] = data[6] = data[7] = 0;
+		memcpy(data + 8, &timestamp_ns, sizeof(timestamp_ns));
+		memcpy(data + 16, &hash, sizeof(hash));
+		memcpy(data + RECORD_HEADER_SIZE, payload, size);
+	});
+	if (!written)
+	{
+		dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void ProtocolTrace::record_frames(Direction direction, Buffer::word_t const* frames, size_t size)
+{
+	size_t position = 0;
+	while (position + FRAME_HEADER_SIZE <= size)
+	{
+		const size_t length = static_cast<size_t>(read_at<int32_t>(frames + position));
+		const RdId id(read_at<RdId::hash_t>(frames + position + sizeof(int32_t)));
+		record(direction, id, frames + position + FRAME_HEADER_SIZE, length - sizeof(RdId::hash_t));
+		position += sizeof(int32_t) + length;
+	}
+}
+
+void ProtocolTrace::flush()
+{
+	log.flush();
+}
+
+uint64_t ProtocolTrace::get_dropped() const
+{
+	return dropped.load(std::memory_order_relaxed);
+}
+
+spdlog::filename_t ProtocolTrace::filename()
+{
+	return log.filename();
+}
+
+ProtocolTraceReader::ProtocolTraceReader(Buffer::ByteArray contents) : contents(std::move(contents))
+{
+	if (this->contents.size() >= ProtocolTrace::FILE_HEADER_SIZE &&
+		memcmp(this->contents.data(), MAGIC, sizeof(MAGIC)) == 0 &&
+		read_at<uint32_t>(this->contents.data() + 8) == ProtocolTrace::VERSION)
+	{
+		valid_ = true;
+		position = ProtocolTrace::FILE_HEADER_SIZE;
+	}
+}
+
+ProtocolTraceReader ProtocolTraceReader::open(spdlog::filename_t const& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	return ProtocolTraceReader(Buffer::ByteArray(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+}
+
+bool ProtocolTraceReader::valid() const
+{
+	return valid_;
+}
+
+bool ProtocolTraceReader::next(ProtocolTrace::Record& record)
+{
+	if (!valid_ || position + ProtocolTrace::RECORD_HEADER_SIZE > contents.size())
+	{
+		return false;
+	}
+	Buffer::word_t const* data = contents.data() + position;
+	const size_t size = read_at<uint32_t>(data);
+	const int64_t timestamp_ns = read_at<int64_t>(data + 8);
+	// the zero tail of a segment which is still being written
+	if (timestamp_ns == 0 || position + ProtocolTrace::RECORD_HEADER_SIZE + size > contents.size())
+	{
+		return false;
+	}
+	record.direction = static_cast<ProtocolTrace::Direction>(data[4]);
+	record.timestamp_ns = timestamp_ns;
+	record.id = RdId(read_at<RdId::hash_t>(data + 16));
+	record.payload = data + ProtocolTrace::RECORD_HEADER_SIZE;
+	record.size = size;
+	position += ProtocolTrace::RECORD_HEADER_SIZE + size;
+	return true;
+}
+
+ProtocolTraceReplay::Wire::Wire(IScheduler* scheduler) : WireBase(scheduler)
+{
+	connected.set(true);
+}
+
+void ProtocolTraceReplay::Wire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+{
+	send_inline(id, writer);
+}
+
+void ProtocolTraceReplay::Wire::send_inline(RdId const& /*id*/, util::function_ref<void(Buffer& buffer)> writer) const
+{
+	// writers may have side effects the model relies on, the message itself isn't needed
+	Buffer buffer;
+	writer(buffer);
+}
+
+void ProtocolTraceReplay::Wire::advise(Lifetime lifetime, IRdReactive const* entity) const
+{
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		locations[entity->get_id()] = to_string(entity->get_location());
+	}
+	WireBase::advise(lifetime, entity);
+}
+
+std::string ProtocolTraceReplay::Wire::location_of(RdId const& id) const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	auto it = locations.find(id);
+	return it == locations.end() ? std::string{} : it->second;
+}
+
+void ProtocolTraceReplay::Wire::replay(RdId const& id, Buffer::word_t const* payload, size_t size) const
+{
+	message_broker.dispatch(id, Buffer(Buffer::ByteArray(payload, payload + size)));
+}
+
+ProtocolTraceReplay::ProtocolTraceReplay(Identities::IdKind local_kind)
+	: local_wire(std::make_shared<Wire>(&SynchronousScheduler::Instance()))
+	, remote_wire(std::make_shared<Wire>(&SynchronousScheduler::Instance()))
+{
+	const Identities::IdKind remote_kind = local_kind == Identities::SERVER ? Identities::CLIENT : Identities::SERVER;
+	local_protocol = std::make_unique<Protocol>(local_kind, &SynchronousScheduler::Instance(), local_wire, lifetime);
+	remote_protocol = std::make_unique<Protocol>(remote_kind, &SynchronousScheduler::Instance(), remote_wire, lifetime);
+}
+
+ProtocolTraceReplay::~ProtocolTraceReplay()
+{
+	lifetime_definition.terminate();
+}
+
+void ProtocolTraceReplay::replay(ProtocolTrace::Record const& record) const
+{
+	Wire const& wire = record.direction == ProtocolTrace::Direction::Receive ? *local_wire : *remote_wire;
+	wire.replay(record.id, record.payload, record.size);
+}
+
+std::string ProtocolTraceReplay::describe(ProtocolTrace::Record const& record) const
+{
+	const bool received = record.direction == ProtocolTrace::Direction::Receive;
+	// the recipient is bound on the side the message was delivered to
+	std::string location = (received ? local_wire : remote_wire)->location_of(record.id);
+	if (location.empty())
+	{
+		location = "<unknown>";
+	}
+	return fmt::format("{}.{:09} {} {} ({}) {} bytes", record.timestamp_ns / 1000000000, record.timestamp_ns % 1000000000,
+		received ? "RECV" : "SEND", location, record.id.get_hash(), record.size);
+}
+
+size_t ProtocolTraceReplay::replay_all(
+	ProtocolTraceReader& reader, util::function_ref<void(ProtocolTrace::Record const&)> on_record) const
+{
+	size_t count = 0;
+	ProtocolTrace::Record record{};
+	while (reader.next(record))
+	{
+		on_record(record);
+		replay(record);
+		++count;
+	}
+	return count;
+}
+}	 // namespace rd
@@ -0,0 +1,213 @@
+#ifndef RD_CPP_PROTOCOLTRACE_H
+#define RD_CPP_PROTOCOLTRACE_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "base/WireBase.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "protocol/Buffer.h"
+#include "protocol/Identities.h"
+#include "protocol/Protocol.h"
+#include "protocol/RdId.h"
+#include "scheduler/SynchronousScheduler.h"
+#include "std/unordered_map.h"
+#include "util/MappedLog.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Binary trace of the messages a wire sends and receives, appended to memory-mapped segments, see [MappedLog].
+ *
+ * \details A record is the raw message with its recipient id, direction and time; nothing is deserialized or formatted
+ * while recording. Records are decoded offline by [ProtocolTraceReader] and rendered by replaying them into
+ * the model with [ProtocolTraceReplay]. Layout, in the byte order of [Buffer]: uint32 payload size, uint8 direction,
+ * 3 reserved bytes, int64 nanoseconds since the epoch, int64 recipient id, payload. The payload is what the wire
+ * delivers to the entity, int16 context followed by what the entity wrote, so the entity's operation (e.g. add
+ * or remove of a map) is its first field. Each segment file starts with a header of magic and format version.
+ */
+class RD_FRAMEWORK_API ProtocolTrace
+{
+public:
+	enum class Direction : uint8_t
+	{
+		Send,
+		Receive
+	};
+
+	struct Record
+	{
+		Direction direction;
+		int64_t timestamp_ns;
+		RdId id;
+		Buffer::word_t const* payload;
+		size_t size;
+	};
+
+	static constexpr uint32_t VERSION = 1;
+	static constexpr size_t FILE_HEADER_SIZE = 16;
+	static constexpr size_t RECORD_HEADER_SIZE = 24;
+
+private:
+	util::MappedLog log;
+	std::atomic<uint64_t> dropped{0};
+
+public:
+	// region ctor/dtor
+
+	explicit ProtocolTrace(spdlog::filename_t base_filename, size_t segment_size = util::MappedLog::DEFAULT_SEGMENT_SIZE,
+		size_t max_files = util::MappedLog::DEFAULT_MAX_FILES);
+
+	ProtocolTrace(ProtocolTrace const&) = delete;
+
+	ProtocolTrace& operator=(ProtocolTrace const&) = delete;
+	// endregion
+
+	/**
+	 * \brief Records the message [payload] of [size] bytes to the entity with the given [id].
+	 */
+	void record(Direction direction, RdId const& id, Buffer::word_t const* payload, size_t size);
+
+	/**
+	 * \brief Records each message of [frames] written by [IWire::write_frame].
+	 */
+	void record_frames(Direction direction, Buffer::word_t const* frames, size_t size);
+
+	/**
+	 * \brief Schedules write-back of the active segment, records are already visible to readers of the file.
+	 */
+	void flush();
+
+	/**
+	 * \brief Number of records which were lost: too large for a segment, or no segment could be opened.
+	 */
+	uint64_t get_dropped() const;
+
+	/**
+	 * \brief File of the active segment.
+	 */
+	spdlog::filename_t filename();
+};
+
+/**
+ * \brief Iterates over the records of one [ProtocolTrace] segment file.
+ */
+class RD_FRAMEWORK_API ProtocolTraceReader
+{
+	Buffer::ByteArray contents;
+	size_t position = 0;
+	bool valid_ = false;
+
+public:
+	// region ctor/dtor
+
+	explicit ProtocolTraceReader(Buffer::ByteArray contents);
+	// endregion
+
+	static ProtocolTraceReader open(spdlog::filename_t const& filename);
+
+	/**
+	 * \brief False if the contents don't start with the header of a known format version.
+	 */
+	bool valid() const;
+
+	/**
+	 * \brief Reads the next record into [record], false at the end of the trace. The record's payload points into
+	 * the reader's contents.
+	 */
+	bool next(ProtocolTrace::Record& record);
+};
+
+/**
+ * \brief Replays trace records into models bound to two protocols standing for the traced side and its counterpart,
+ * so that entities deserialize the messages with the model's own serializers.
+ *
+ * \details Received records are dispatched to [local_protocol], sent ones to [remote_protocol], as each side would have
+ * received them. Entities render what they receive in the trace loggers of their protocol, which
+ * [IProtocol::set_loggers] routes to the output; handlers advised on them see the values. Messages sent by
+ * the replayed models are dropped. Bind the models to both protocols, as on the traced connection, before replaying.
+ */
+class RD_FRAMEWORK_API ProtocolTraceReplay
+{
+public:
+	/**
+	 * \brief Connected wire which delivers replayed messages and drops sent ones.
+	 */
+	class RD_FRAMEWORK_API Wire final : public WireBase
+	{
+		mutable std::mutex lock;
+		// kept after the entity is unbound, records may still refer to it
+		mutable rd::unordered_map<RdId, std::string> locations;
+
+	public:
+		// region ctor/dtor
+
+		explicit Wire(IScheduler* scheduler);
+		// endregion
+
+		void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+		void send_inline(RdId const& id, util::function_ref<void(Buffer& buffer)> writer) const override;
+
+		void advise(Lifetime lifetime, IRdReactive const* entity) const override;
+
+		void replay(RdId const& id, Buffer::word_t const* payload, size_t size) const;
+
+		/**
+		 * \brief Location of the entity which was bound under [id], empty if none was.
+		 */
+		std::string location_of(RdId const& id) const;
+	};
+
+	LifetimeDefinition lifetime_definition{Lifetime::Eternal()};
+	Lifetime lifetime = lifetime_definition.lifetime;
+
+	std::shared_ptr<Wire> local_wire;
+	std::shared_ptr<Wire> remote_wire;
+
+	std::unique_ptr<Protocol> local_protocol;
+	std::unique_ptr<Protocol> remote_protocol;
+
+	// region ctor/dtor
+
+	/**
+	 * \param local_kind identity kind of the traced side, e.g. SERVER for the Unreal Editor end of RiderLink
+	 */
+	explicit ProtocolTraceReplay(Identities::IdKind local_kind);
+
+	ProtocolTraceReplay(ProtocolTraceReplay const&) = delete;
+
+	ProtocolTraceReplay& operator=(ProtocolTraceReplay const&) = delete;
+
+	virtual ~ProtocolTraceReplay();
+	// endregion
+
+	void replay(ProtocolTrace::Record const& record) const;
+
+	/**
+	 * \brief One line summary of [record]: time, direction, recipient and payload size.
+	 */
+	std::string describe(ProtocolTrace::Record const& record) const;
+
+	/**
+	 * \brief Replays all records of [reader], passing each to [on_record] first.
+	 * \return number of records replayed
+	 */
+	size_t replay_all(ProtocolTraceReader& reader, util::function_ref<void(ProtocolTrace::Record const&)> on_record) const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_PROTOCOLTRACE_H
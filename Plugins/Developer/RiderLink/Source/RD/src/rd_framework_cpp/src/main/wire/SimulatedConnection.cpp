@@ -0,0 +1,87 @@
+#include "wire/SimulatedConnection.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace rd
+{
+namespace test
+{
+namespace util
+{
+SimulatedConnection::SimulatedConnection(LinkParameters to_client, LinkParameters to_server)
+	: server_wire(std::make_shared<SimulatedWire>(&scheduler, to_client))
+	, client_wire(std::make_shared<SimulatedWire>(&scheduler, to_server))
+{
+	SimulatedWire::connect(*server_wire, *client_wire);
+	server_protocol = std::make_unique<Protocol>(Identities::SERVER, &scheduler, server_wire, lifetime);
+	client_protocol = std::make_unique<Protocol>(Identities::CLIENT, &scheduler, client_wire, lifetime);
+}
+
+SimulatedConnection::~SimulatedConnection()
+{
+	lifetime_definition.terminate();
+}
+
+void SimulationReport::add(std::string workload, std::string metric, double value, std::string unit)
+{
+	entries.push_back(Entry{std::move(workload), std::move(metric), value, std::move(unit)});
+}
+
+void SimulationReport::add_latencies(std::string const& workload, std::vector<duration> samples)
+{
+	add(workload, "latency_count", static_cast<double>(samples.size()), "messages");
+	if (samples.empty())
+	{
+		return;
+	}
+	std::sort(samples.begin(), samples.end());
+	const auto percentile = [&samples](size_t p) {
+		const duration sample = samples[(std::min)(samples.size() - 1, samples.size() * p / 100)];
+		return std::chrono::duration<double, std::micro>(sample).count();
+	};
+	add(workload, "latency_p50", percentile(50), "us");
+	add(workload, "latency_p90", percentile(90), "us");
+	add(workload, "latency_p99", percentile(99), "us");
+	add(workload, "latency_max", std::chrono::duration<double, std::micro>(samples.back()).count(), "us");
+}
+
+void SimulationReport::add_throughput(std::string const& workload, uint64_t messages, uint64_t bytes, duration elapsed)
+{
+	const double seconds = std::chrono::duration<double>(elapsed).count();
+	add(workload, "elapsed", seconds * 1000, "ms");
+	if (seconds > 0)
+	{
+		add(workload, "throughput", static_cast<double>(messages) / seconds, "messages/s");
+		add(workload, "bandwidth", static_cast<double>(bytes) / seconds, "bytes/s");
+	}
+}
+
+void SimulationReport::add_wire_stats(std::string const& workload, std::string const& side, SimulatedWire::Stats const& stats)
+{
+	add(workload, side + "_sent_messages", static_cast<double>(stats.sent_messages), "messages");
+	add(workload, side + "_sent_bytes", static_cast<double>(stats.sent_bytes), "bytes");
+	add(workload, side + "_retransmissions", static_cast<double>(stats.retransmissions), "messages");
+}
+
+std::vector<SimulationReport::Entry> const& SimulationReport::get_entries() const
+{
+	return entries;
+}
+
+std::string SimulationReport::to_json_lines() const
+{
+	// names are identifiers chosen by the benchmark, they need no escaping
+	std::string result;
+	char value[64];
+	for (auto const& entry : entries)
+	{
+		snprintf(value, sizeof(value), "%.3f", entry.value);
+		result += R"({"workload":")" + entry.workload + R"(","metric":")" + entry.metric + R"(","value":)" + value +
+				  R"(,"unit":")" + entry.unit + "\"}\n";
+	}
+	return result;
+}
+}	 // namespace util
+}	 // namespace test
+}	 // namespace rd
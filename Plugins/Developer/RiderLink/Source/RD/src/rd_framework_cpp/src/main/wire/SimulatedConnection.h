@@ -0,0 +1,118 @@
+#ifndef RD_CPP_SIMULATEDCONNECTION_H
+#define RD_CPP_SIMULATEDCONNECTION_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "wire/SimulatedWire.h"
+#include "scheduler/SimulatedScheduler.h"
+#include "protocol/Protocol.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "base/RdBindableBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace test
+{
+namespace util
+{
+/**
+ * \brief Server and client Protocol connected by a pair of SimulatedWire driven by one SimulatedScheduler.
+ */
+class RD_FRAMEWORK_API SimulatedConnection
+{
+public:
+	using duration = SimulatedScheduler::duration;
+
+	SimulatedScheduler scheduler;
+
+	LifetimeDefinition lifetime_definition{Lifetime::Eternal()};
+	Lifetime lifetime = lifetime_definition.lifetime;
+
+	// sends to the client
+	std::shared_ptr<SimulatedWire> server_wire;
+	// sends to the server
+	std::shared_ptr<SimulatedWire> client_wire;
+
+	std::unique_ptr<Protocol> server_protocol;
+	std::unique_ptr<Protocol> client_protocol;
+
+	// region ctor/dtor
+
+	explicit SimulatedConnection(LinkParameters to_client = {}, LinkParameters to_server = {});
+
+	SimulatedConnection(SimulatedConnection const&) = delete;
+
+	SimulatedConnection& operator=(SimulatedConnection const&) = delete;
+
+	virtual ~SimulatedConnection();
+	// endregion
+
+	/**
+	 * \brief Binds [server] and [client] sides of an entity under static [id], e.g. RdCall and RdEndpoint.
+	 */
+	template <typename S, typename C>
+	void bind_static(S& server, C& client, std::string const& name, int64_t id)
+	{
+		statics(server, id);
+		statics(client, id);
+		server.bind(lifetime, server_protocol.get(), name);
+		client.bind(lifetime, client_protocol.get(), name);
+	}
+};
+
+/**
+ * \brief Metrics of simulated workloads, printed as JSON lines in the order they were added so that reports
+ * of two builds can be diffed.
+ */
+class RD_FRAMEWORK_API SimulationReport
+{
+public:
+	using duration = SimulatedScheduler::duration;
+
+	struct Entry
+	{
+		std::string workload;
+		std::string metric;
+		double value;
+		std::string unit;
+	};
+
+private:
+	std::vector<Entry> entries;
+
+public:
+	void add(std::string workload, std::string metric, double value, std::string unit);
+
+	/**
+	 * \brief Adds count, p50, p90, p99 and max of [samples] in microseconds.
+	 */
+	void add_latencies(std::string const& workload, std::vector<duration> samples);
+
+	/**
+	 * \brief Adds messages and bytes per second of virtual time.
+	 */
+	void add_throughput(std::string const& workload, uint64_t messages, uint64_t bytes, duration elapsed);
+
+	void add_wire_stats(std::string const& workload, std::string const& side, SimulatedWire::Stats const& stats);
+
+	std::vector<Entry> const& get_entries() const;
+
+	std::string to_json_lines() const;
+};
+}	 // namespace util
+}	 // namespace test
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_SIMULATEDCONNECTION_H
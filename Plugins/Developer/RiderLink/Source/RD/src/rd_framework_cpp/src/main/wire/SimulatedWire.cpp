@@ -0,0 +1,116 @@
+#include "wire/SimulatedWire.h"
+#include "wire/ProtocolTrace.h"
+
+#include "util/core_util.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace rd
+{
+namespace test
+{
+namespace util
+{
+SimulatedWire::SimulatedWire(SimulatedScheduler* scheduler, LinkParameters link)
+	: WireBase(scheduler), simulated_scheduler(scheduler), link(link), random_state(link.seed ? link.seed : 1)
+{
+}
+
+void SimulatedWire::connect(SimulatedWire& a, SimulatedWire& b)
+{
+	a.counterpart = &b;
+	b.counterpart = &a;
+	a.connected.set(true);
+	b.connected.set(true);
+}
+
+double SimulatedWire::next_random() const
+{
+	// xorshift64*
+	random_state ^= random_state >> 12;
+	random_state ^= random_state << 25;
+	random_state ^= random_state >> 27;
+	return static_cast<double>((random_state * 0x2545F4914F6CDD1Dull) >> 11) / static_cast<double>(1ull << 53);
+}
+
+SimulatedWire::duration SimulatedWire::arrival_time(size_t size) const
+{
+	const duration now = simulated_scheduler->now();
+	duration transmission{0};
+	if (link.bandwidth != 0)
+	{
+		transmission = duration(static_cast<int64_t>(size * 1000000000ull / link.bandwidth));
+	}
+	duration sent = (std::max)(now, link_free_at) + transmission;
+	while (link.loss > 0 && next_random() < link.loss)
+	{
+		// the lost copy occupied the link too
+		sent += link.retransmit_timeout + transmission;
+		++stats.retransmissions;
+	}
+	link_free_at = sent;
+
+	duration arrival = sent + link.latency;
+	if (link.jitter.count() > 0)
+	{
+		arrival += duration(static_cast<int64_t>(next_random() * static_cast<double>(link.jitter.count())));
+	}
+	// a stream doesn't reorder: nothing arrives before the previous message
+	last_arrival = (std::max)(arrival, last_arrival);
+	return last_arrival;
+}
+
+void SimulatedWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) const
+{
+	send_inline(id, writer);
+}
+
+void SimulatedWire::send_inline(RdId const& id, rd::util::function_ref<void(Buffer& buffer)> writer) const
+{
+	RD_ASSERT_MSG(!id.isNull(), "id mustn't be null");
+	RD_ASSERT_MSG(counterpart != nullptr, "SimulatedWire isn't connected");
+
+	Buffer buffer;
+	buffer.write_integral<int16_t>(0);	  // placeholder for context
+	writer(buffer);
+
+	if (trace)
+	{
+		trace->record(ProtocolTrace::Direction::Send, id, buffer.data(), buffer.get_position());
+	}
+
+	const size_t size = buffer.get_position() + link.header_size;
+	++stats.sent_messages;
+	stats.sent_bytes += size;
+
+	auto data = std::make_shared<Buffer::ByteArray>(std::move(buffer).getRealArray());
+	SimulatedWire const* receiver = counterpart;
+	simulated_scheduler->queue_at(arrival_time(size), [this, receiver, id, data] {
+		++stats.delivered_messages;
+		if (receiver->trace)
+		{
+			receiver->trace->record(ProtocolTrace::Direction::Receive, id, data->data(), data->size());
+		}
+		receiver->message_broker.dispatch(id, Buffer(std::move(*data)));
+	});
+}
+
+void SimulatedWire::set_link(LinkParameters parameters)
+{
+	link = parameters;
+	random_state = link.seed ? link.seed : 1;
+}
+
+LinkParameters const& SimulatedWire::get_link() const
+{
+	return link;
+}
+
+SimulatedWire::Stats const& SimulatedWire::get_stats() const
+{
+	return stats;
+}
+}	 // namespace util
+}	 // namespace test
+}	 // namespace rd
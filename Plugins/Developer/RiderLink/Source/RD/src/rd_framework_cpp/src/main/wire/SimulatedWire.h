@@ -0,0 +1,110 @@
+#ifndef RD_CPP_SIMULATEDWIRE_H
+#define RD_CPP_SIMULATEDWIRE_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "base/WireBase.h"
+#include "scheduler/SimulatedScheduler.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace test
+{
+namespace util
+{
+/**
+ * \brief One direction of a simulated connection.
+ */
+struct LinkParameters
+{
+	using duration = SimulatedScheduler::duration;
+
+	// one-way propagation delay
+	duration latency{0};
+	// extra delay up to this value, drawn per message
+	duration jitter{0};
+	// bytes per second, 0 for unlimited
+	uint64_t bandwidth = 0;
+	// probability that a transmission is lost and repeated after [retransmit_timeout]
+	double loss = 0;
+	duration retransmit_timeout = std::chrono::milliseconds(200);
+	// framing added by SocketWire: length and id
+	size_t header_size = sizeof(int32_t) + sizeof(int64_t);
+	uint64_t seed = 1;
+};
+
+/**
+ * \brief Wire delivering messages to its counterpart through a SimulatedScheduler with the delays of a modelled link.
+ *
+ * \details Messages are serialized on send and occupy the link for their size divided by bandwidth, then arrive after
+ * the latency. Like over TCP, a lost transmission is repeated after the retransmit timeout and holds back
+ * the messages behind it, so messages are never reordered or dropped. Random draws come from a generator
+ * seeded by the link parameters, which keeps simulations deterministic.
+ */
+class RD_FRAMEWORK_API SimulatedWire final : public WireBase
+{
+public:
+	using duration = SimulatedScheduler::duration;
+
+	struct Stats
+	{
+		uint64_t sent_messages = 0;
+		// including headers
+		uint64_t sent_bytes = 0;
+		uint64_t delivered_messages = 0;
+		uint64_t retransmissions = 0;
+	};
+
+private:
+	SimulatedScheduler* simulated_scheduler;
+	SimulatedWire const* counterpart = nullptr;
+	LinkParameters link;
+
+	mutable duration link_free_at{0};
+	mutable duration last_arrival{0};
+	mutable uint64_t random_state;
+	mutable Stats stats;
+
+	double next_random() const;
+
+	duration arrival_time(size_t size) const;
+
+public:
+	// region ctor/dtor
+
+	explicit SimulatedWire(SimulatedScheduler* scheduler, LinkParameters link = {});
+
+	virtual ~SimulatedWire() = default;
+	// endregion
+
+	/**
+	 * \brief Makes [a] and [b] deliver to each other and marks them connected.
+	 */
+	static void connect(SimulatedWire& a, SimulatedWire& b);
+
+	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	void send_inline(RdId const& id, rd::util::function_ref<void(Buffer& buffer)> writer) const override;
+
+	void set_link(LinkParameters parameters);
+
+	LinkParameters const& get_link() const;
+
+	Stats const& get_stats() const;
+};
+}	 // namespace util
+}	 // namespace test
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_SIMULATEDWIRE_H
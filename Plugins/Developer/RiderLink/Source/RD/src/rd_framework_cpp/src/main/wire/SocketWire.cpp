@@ -1,4 +1,5 @@
 #include "wire/SocketWire.h"
+#include "wire/ProtocolTrace.h"
 
 #include <util/thread_util.h>
 
@@ -11,14 +12,76 @@
 #include <utility>
 #include <thread>
 #include <csignal>
+#include <cstring>
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
 
 namespace rd
 {
+namespace
+{
+// The socket stays blocking for the sender thread, so only the receive calls are made non-blocking.
+#ifdef _WIN32
+int32_t recv_nonblocking(SOCKET socket, Buffer::word_t* data, int32_t size)
+{
+	// there is no per-call flag: check readiness first, a readable socket doesn't block in recv
+	WSAPOLLFD fd{socket, POLLRDNORM, 0};
+	if (WSAPoll(&fd, 1, 0) == 0)
+	{
+		WSASetLastError(WSAEWOULDBLOCK);
+		return -1;
+	}
+	return recv(socket, reinterpret_cast<char*>(data), size, 0);
+}
+
+bool would_block()
+{
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+
+bool interrupted()
+{
+	return WSAGetLastError() == WSAEINTR;
+}
+
+int wait_readable(SOCKET socket, std::chrono::milliseconds timeout)
+{
+	WSAPOLLFD fd{socket, POLLRDNORM, 0};
+	return WSAPoll(&fd, 1, static_cast<INT>(timeout.count()));
+}
+#else
+int32_t recv_nonblocking(SOCKET socket, Buffer::word_t* data, int32_t size)
+{
+	return static_cast<int32_t>(recv(socket, data, static_cast<size_t>(size), MSG_DONTWAIT));
+}
+
+bool would_block()
+{
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+
+bool interrupted()
+{
+	return errno == EINTR;
+}
+
+int wait_readable(SOCKET socket, std::chrono::milliseconds timeout)
+{
+	pollfd fd{socket, POLLIN, 0};
+	return poll(&fd, 1, static_cast<int>(timeout.count()));
+}
+#endif
+}	 // namespace
+
 std::shared_ptr<spdlog::logger> SocketWire::Base::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("wireLog", spdlog::color_mode::automatic);
 
 std::chrono::milliseconds SocketWire::timeout = std::chrono::milliseconds(500);
 
+std::atomic<bool> SocketWire::Base::use_io_uring{false};
+
 constexpr int32_t SocketWire::Base::ACK_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PING_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PACKAGE_HEADER_LENGTH;
@@ -29,6 +92,8 @@ SocketWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* sche
 	async_send_buffer.pause("initial");
 	async_send_buffer.start();
 	ping_pkg_header.write_integral(PING_MESSAGE_LENGTH);
+	util::MetricsRegistry::instance().add_source(
+		lifetimeDef.lifetime, [this](util::MetricsSnapshot& snapshot) { collect_metrics(snapshot); });
 }
 
 SocketWire::Base::~Base()
@@ -79,6 +144,22 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 		send_package_header.rewind();
 		send_package_header.write_integral(msglen);
 		send_package_header.write_integral(seqn);
+		if (util::MetricsRegistry::is_enabled())
+		{
+			sent_bytes.add(PACKAGE_HEADER_LENGTH + msg.size());
+			sent_package_sizes.record(msg.size());
+		}
+
+		if (uring)
+		{
+			RD_ASSERT_THROW_MSG(uring->send({{send_package_header.data(), send_package_header.get_position()}, {msg.data(), msg.size()}}),
+				this->id +
+					": failed to send package over the network"
+					", reason: " +
+					std::strerror(errno));
+			logger->info("{}: were sent {} bytes", this->id, msglen);
+			return true;
+		}
 
 		RD_ASSERT_THROW_MSG(
 			socket_provider->Send(send_package_header.data(), send_package_header.get_position()) == PACKAGE_HEADER_LENGTH,
@@ -105,20 +186,135 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 
 void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
 {
-	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
+	send_inline(rd_id, writer);
+}
+
+void SocketWire::Base::send_inline(RdId const& rd_id, util::function_ref<void(Buffer& buffer)> writer) const
+{
+	RD_ASSERT_MSG(!rd_id.isNull(), id + ": id mustn't be null");
 
 	Buffer local_send_buffer;
-	local_send_buffer.write_integral<int32_t>(0);	 // placeholder for length
-	rd_id.write(local_send_buffer);					 // write id
-	local_send_buffer.write_integral<int16_t>(0);	 // placeholder for context
-	writer(local_send_buffer);						 // write rest
+	write_frame(local_send_buffer, rd_id, writer);
+	if (trace)
+	{
+		constexpr size_t header_size = sizeof(int32_t) + sizeof(RdId::hash_t);
+		trace->record(ProtocolTrace::Direction::Send, rd_id, local_send_buffer.data() + header_size,
+			local_send_buffer.get_position() - header_size);
+	}
+	async_send_buffer.put(std::move(local_send_buffer).getRealArray(), lane_of(rd_id));
+}
 
-	int32_t len = static_cast<int32_t>(local_send_buffer.get_position());
+void SocketWire::Base::send_frames(Buffer::ByteArray frames) const
+{
+	if (trace)
+	{
+		trace->record_frames(ProtocolTrace::Direction::Send, frames.data(), frames.size());
+	}
+	if (!has_priorities.load(std::memory_order_acquire))
+	{
+		async_send_buffer.put(std::move(frames), ByteBufferAsyncProcessor::DEFAULT_LANE);
+		return;
+	}
 
-	local_send_buffer.rewind();
-	local_send_buffer.write_integral<int32_t>(len - 4);
-	local_send_buffer.set_position(len);
-	async_send_buffer.put(std::move(local_send_buffer).getRealArray());
+	// consecutive frames of one lane stay together, runs of other lanes are copied out
+	Buffer buffer(std::move(frames));
+	const size_t end = buffer.get_data().size();
+	size_t run_start = 0;
+	size_t run_lane = ByteBufferAsyncProcessor::DEFAULT_LANE;
+	while (buffer.get_position() < end)
+	{
+		const size_t frame_start = buffer.get_position();
+		const size_t length = static_cast<size_t>(buffer.read_integral<int32_t>());
+		const size_t lane = lane_of(RdId::read(buffer));
+		if (lane != run_lane && frame_start != run_start)
+		{
+			async_send_buffer.put(Buffer::ByteArray(buffer.data() + run_start, buffer.data() + frame_start), run_lane);
+			run_start = frame_start;
+		}
+		run_lane = lane;
+		buffer.set_position(frame_start + sizeof(int32_t) + length);
+	}
+	if (run_start == 0)
+	{
+		async_send_buffer.put(std::move(buffer.get_data()), run_lane);
+	}
+	else if (run_start != end)
+	{
+		async_send_buffer.put(Buffer::ByteArray(buffer.data() + run_start, buffer.data() + end), run_lane);
+	}
+}
+
+size_t SocketWire::Base::lane_of(RdId const& rd_id) const
+{
+	static_assert(static_cast<size_t>(SendPriority::Bulk) < ByteBufferAsyncProcessor::LANES, "a lane per priority");
+	static_assert(static_cast<size_t>(SendPriority::Normal) == ByteBufferAsyncProcessor::DEFAULT_LANE, "Normal is default");
+
+	if (!has_priorities.load(std::memory_order_acquire))
+	{
+		return ByteBufferAsyncProcessor::DEFAULT_LANE;
+	}
+	std::lock_guard<decltype(priority_lock)> guard(priority_lock);
+	auto it = priorities.find(rd_id);
+	return it == priorities.end() ? ByteBufferAsyncProcessor::DEFAULT_LANE : static_cast<size_t>(it->second);
+}
+
+void SocketWire::Base::set_priority(Lifetime lifetime, RdId const& rd_id, SendPriority priority) const
+{
+	RD_ASSERT_MSG(!rd_id.isNull(), id + ": id mustn't be null");
+
+	lifetime->bracket(
+		[this, rd_id, priority] {
+			std::lock_guard<decltype(priority_lock)> guard(priority_lock);
+			priorities[rd_id] = priority;
+			has_priorities.store(true, std::memory_order_release);
+		},
+		[this, rd_id] {
+			std::lock_guard<decltype(priority_lock)> guard(priority_lock);
+			priorities.erase(rd_id);
+			has_priorities.store(!priorities.empty(), std::memory_order_release);
+		});
+}
+
+void SocketWire::Base::set_priority_weight(SendPriority priority, uint32_t weight) const
+{
+	async_send_buffer.set_lane_weight(static_cast<size_t>(priority), weight);
+}
+
+void SocketWire::Base::set_send_window(size_t bytes) const
+{
+	async_send_buffer.set_window(bytes);
+}
+
+void SocketWire::Base::set_max_queued_bytes(size_t bytes) const
+{
+	async_send_buffer.set_max_queued_bytes(bytes);
+}
+
+void SocketWire::Base::set_overflow_policy(SendPriority priority, ByteBufferAsyncProcessor::OverflowPolicy policy) const
+{
+	async_send_buffer.set_overflow_policy(static_cast<size_t>(priority), policy);
+}
+
+ByteBufferAsyncProcessor::Stats SocketWire::Base::get_send_stats() const
+{
+	return async_send_buffer.get_stats();
+}
+
+void SocketWire::Base::collect_metrics(util::MetricsSnapshot& snapshot) const
+{
+	const std::string prefix = "socket_wire." + this->id + ".";
+	const auto stats = async_send_buffer.get_stats();
+	snapshot.add(prefix + "queued_packages", static_cast<double>(stats.queued_packages));
+	snapshot.add(prefix + "queued_bytes", static_cast<double>(stats.queued_bytes));
+	snapshot.add(prefix + "pending_ack_packages", static_cast<double>(stats.pending_packages));
+	snapshot.add(prefix + "pending_ack_bytes", static_cast<double>(stats.pending_bytes));
+	snapshot.add(prefix + "dropped_packages", static_cast<double>(stats.dropped_packages));
+	snapshot.add(prefix + "dropped_bytes", static_cast<double>(stats.dropped_bytes));
+	snapshot.add(prefix + "blocked_puts", static_cast<double>(stats.blocked_puts));
+	snapshot.add(prefix + "sent_bytes", static_cast<double>(sent_bytes.get()));
+	snapshot.add(prefix + "received_bytes", static_cast<double>(received_bytes.get()));
+	snapshot.add(prefix + "sent_package_size", sent_package_sizes);
+	message_broker.collect_metrics(snapshot, prefix);
 }
 
 void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_socket)
@@ -126,6 +322,14 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	{
 		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 		socket_provider = std::move(new_socket);
+		uring.reset();
+#if defined(__linux__)
+		if (use_io_uring.load())
+		{
+			uring = UringSocket::create(socket_provider->GetSocketDescriptor(), receiver_buffer.data(), RECEIVE_BUFFER_SIZE);
+			logger->debug("{}: socket I/O through {}", this->id, uring ? "io_uring" : "the socket, io_uring is unavailable");
+		}
+#endif
 		socket_send_var.notify_all();
 	}
 	{
@@ -143,6 +347,7 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 
 		connected.set(true);
 
+		pending_ack_seqn = 0;
 		receiverProc();
 
 		connected.set(false);
@@ -182,6 +387,52 @@ std::future<void> SocketWire::Base::start_heartbeat(Lifetime lifetime)
 	});
 }
 
+int32_t SocketWire::Base::receive_available(Buffer::word_t* data, int32_t size) const
+{
+	if (uring)
+	{
+		while (true)
+		{
+			const int32_t read = uring->receive(data, size, timeout);
+			if (read != UringSocket::TIMED_OUT)
+			{
+				return read;
+			}
+			if (!socket_provider->IsSocketValid())
+			{
+				return 0;
+			}
+		}
+	}
+
+	const SOCKET fd = socket_provider->GetSocketDescriptor();
+	while (true)
+	{
+		const int32_t read = recv_nonblocking(fd, data, size);
+		if (read >= 0)
+		{
+			return read;
+		}
+		if (interrupted())
+		{
+			continue;
+		}
+		if (!would_block())
+		{
+			return -1;
+		}
+		// shutdown of the socket wakes the wait up, the timeout only guards against a missed one
+		if (wait_readable(fd, timeout) < 0 && !interrupted())
+		{
+			return -1;
+		}
+		if (!socket_provider->IsSocketValid())
+		{
+			return 0;
+		}
+	}
+}
+
 bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) const
 {
 	int32_t ptr = 0;
@@ -198,43 +449,44 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 			std::copy(lo, lo + copylen, res + ptr);
 			lo += copylen;
 			ptr += copylen;
+			continue;
 		}
-		else
+
+		// the buffer is drained, so every receive gets all of it and may bring several packages at once
+		hi = lo = receiver_buffer.begin();
+		if (pending_ack_seqn != 0)
 		{
-			if (hi == receiver_buffer.end())
-			{
-				hi = lo = receiver_buffer.begin();
-			}
-			logger->info("{}: receive started", this->id);
-			int32_t read = socket_provider->Receive(static_cast<int32_t>(receiver_buffer.end() - hi), &*hi);
-			if (read == -1)
-			{
-				auto err = socket_provider->GetSocketError();
-				if (err == CSimpleSocket::SocketInvalidSocket)
-				{
-					logger->info("{}: socket was shut down for receiving", this->id);
-					return false;
-				}
-				logger->error("{}: error has occurred while receiving", this->id);
-				return false;
-			}
-			if (read == 0)
+			send_ack(pending_ack_seqn);
+			pending_ack_seqn = 0;
+		}
+		const bool direct = rest >= static_cast<int32_t>(RECEIVE_BUFFER_SIZE);
+		const int32_t read = direct ? receive_available(res + ptr, rest)
+									: receive_available(&*hi, static_cast<int32_t>(RECEIVE_BUFFER_SIZE));
+		if (read == -1)
+		{
+			if (!socket_provider->IsSocketValid())
 			{
 				logger->info("{}: socket was shut down for receiving", this->id);
 				return false;
 			}
+			logger->error("{}: error has occurred while receiving", this->id);
+			return false;
+		}
+		if (read == 0)
+		{
+			logger->info("{}: socket was shut down for receiving", this->id);
+			return false;
+		}
+		logger->trace("{}: {} bytes received", this->id, read);
+		if (direct)
+		{
+			ptr += read;
+		}
+		else
+		{
 			hi += read;
-			if (read > 0)
-			{
-				logger->info("{}: receive finished: {} bytes read", this->id, read);
-			}
 		}
 	}
-	if (ptr != msglen)
-	{
-		logger->error("read invalid number of bytes from socket, expected: {}, actual: {}", msglen, ptr);
-		assert(false);
-	}
 	return true;
 }
 
@@ -319,14 +571,18 @@ int32_t SocketWire::Base::read_package() const
 		logger->debug("{}: failed to read package", this->id);
 		return -1;
 	}
-	send_ack(seqn);
+	pending_ack_seqn = seqn;
+	if (util::MetricsRegistry::is_enabled())
+	{
+		received_bytes.add(PACKAGE_HEADER_LENGTH + len);
+	}
 	if (seqn <= max_received_seqn && seqn != 1)
 	{
 		return true;
 	}
 	max_received_seqn = seqn;
 
-	logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+	logger->trace("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
 	return len;
 }
 
@@ -356,6 +612,10 @@ bool SocketWire::Base::read_and_dispatch_message() const
 	}
 
 	logger->debug("{}: message received", this->id);
+	if (trace)
+	{
+		trace->record(ProtocolTrace::Direction::Receive, rd_id, message.data(), sz);
+	}
 	message_broker.dispatch(rd_id, std::move(message));
 	logger->debug("{}: message dispatched", this->id);
 
@@ -371,6 +631,15 @@ CSimpleSocket* SocketWire::Base::get_socket_provider() const
 	return socket_provider.get();
 }
 
+bool SocketWire::Base::send_to_socket(Buffer::word_t const* data, size_t size) const
+{
+	if (uring)
+	{
+		return uring->send({{data, size}});
+	}
+	return socket_provider->Send(data, size) == static_cast<int32_t>(size);
+}
+
 void SocketWire::Base::ping() const
 {
 	if (!connection_established(current_timestamp, counterpart_acknowledge_timestamp))
@@ -393,13 +662,13 @@ void SocketWire::Base::ping() const
 		ping_pkg_header.write_integral(counterpart_timestamp);
 		{
 			std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
-			int32_t sent = socket_provider->Send(ping_pkg_header.data(), ping_pkg_header.get_position());
-			if (sent == 0 && !socket_provider->IsSocketValid())
+			const bool sent = send_to_socket(ping_pkg_header.data(), ping_pkg_header.get_position());
+			if (!sent && !socket_provider->IsSocketValid())
 			{
 				logger->debug("{}: failed to send ping over the network, reason: socket was shut down for sending", this->id);
 				return;
 			}
-			RD_ASSERT_THROW_MSG(sent == PACKAGE_HEADER_LENGTH,
+			RD_ASSERT_THROW_MSG(sent,
 				fmt::format("{}: failed to send ping over the network, reason: {}", this->id, socket_provider->DescribeError()))
 		}
 
@@ -421,7 +690,7 @@ bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 		ack_buffer.write_integral(seqn);
 		{
 			std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
-			RD_ASSERT_THROW_MSG(socket_provider->Send(ack_buffer.data(), ack_buffer.get_position()) == PACKAGE_HEADER_LENGTH,
+			RD_ASSERT_THROW_MSG(send_to_socket(ack_buffer.data(), ack_buffer.get_position()),
 				this->id +
 					": failed to send ack over the network"
 					", reason: " +
@@ -10,9 +10,14 @@
 #include "base/WireBase.h"
 #include "ByteBufferAsyncProcessor.h"
 #include "PkgInputStream.h"
+#include "UringSocket.h"
+#include "util/Metrics.h"
+
+#include "std/unordered_map.h"
 
 #include <string>
 #include <array>
+#include <atomic>
 #include <condition_variable>
 
 #include <rd_framework_export.h>
@@ -45,6 +50,12 @@ public:
 
 		std::shared_ptr<CActiveSocket> socket;
 
+		mutable std::mutex priority_lock;
+		mutable rd::unordered_map<RdId, SendPriority> priorities;
+		mutable std::atomic<bool> has_priorities{false};
+
+		size_t lane_of(RdId const& rd_id) const;
+
 		mutable std::condition_variable socket_send_var;
 		mutable ByteBufferAsyncProcessor async_send_buffer{id + "-AsyncSendProcessor",
 			[this](Buffer::ByteArray const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); }};
@@ -76,6 +87,8 @@ public:
 		mutable Buffer ping_pkg_header{PACKAGE_HEADER_LENGTH};
 
 		mutable sequence_number_t max_received_seqn = 0;
+		// acknowledges are cumulative, one is sent for all packages parsed from a receive
+		mutable sequence_number_t pending_ack_seqn = 0;
 		mutable Buffer send_package_header{PACKAGE_HEADER_LENGTH};
 
 		static constexpr int32_t CHUNK_SIZE = 16370;
@@ -85,6 +98,22 @@ public:
 
 		mutable Buffer message{CHUNK_SIZE};
 
+		// counted while [util::MetricsRegistry::enabled] is set, headers included
+		mutable util::Counter sent_bytes;
+		mutable util::Counter received_bytes;
+		mutable util::Histogram sent_package_sizes;
+
+		// set while connected when io_uring is used, see [use_io_uring]
+		std::unique_ptr<UringSocket> uring;
+
+		bool send_to_socket(Buffer::word_t const* data, size_t size) const;
+
+		/**
+		 * \brief Receives whatever is available, up to [size] bytes, waiting for readiness when nothing is.
+		 * \return number of bytes received, 0 if the socket was shut down and -1 on error.
+		 */
+		int32_t receive_available(Buffer::word_t* data, int32_t size) const;
+
 		bool read_from_socket(Buffer::word_t* res, int32_t msglen) const;
 
 		template <typename T>
@@ -103,6 +132,12 @@ public:
 		CSimpleSocket* get_socket_provider() const;
 
 	public:
+		/**
+		 * \brief Whether connections established afterwards do their socket I/O through io_uring where the kernel
+		 * supports it, see [UringSocket]. Other connections use the socket directly.
+		 */
+		static std::atomic<bool> use_io_uring;
+
 		static constexpr int32_t MaximumHeartbeatDelay = 3;
 		std::chrono::milliseconds heartBeatInterval = std::chrono::milliseconds(500);
 
@@ -126,6 +161,39 @@ public:
 
 		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
 
+		void send_inline(RdId const& rd_id, util::function_ref<void(Buffer& buffer)> writer) const override;
+
+		/**
+		 * \brief Frames are already packages of this wire, they are queued as they are.
+		 */
+		void send_frames(Buffer::ByteArray frames) const override;
+
+		void set_priority(Lifetime lifetime, RdId const& rd_id, SendPriority priority) const override;
+
+		/**
+		 * \brief Sets how many messages of [priority] are sent in a row while messages of lower priorities are waiting.
+		 */
+		void set_priority_weight(SendPriority priority, uint32_t weight) const;
+
+		/**
+		 * \brief Flow control of the send queue, see [ByteBufferAsyncProcessor::set_window].
+		 */
+		void set_send_window(size_t bytes) const;
+
+		/**
+		 * \brief Caps memory of messages waiting to be sent, see [ByteBufferAsyncProcessor::set_max_queued_bytes].
+		 */
+		void set_max_queued_bytes(size_t bytes) const;
+
+		void set_overflow_policy(SendPriority priority, ByteBufferAsyncProcessor::OverflowPolicy policy) const;
+
+		ByteBufferAsyncProcessor::Stats get_send_stats() const;
+
+		/**
+		 * \brief Reports traffic, the send queue and dispatched messages as "socket_wire.[id].*".
+		 */
+		void collect_metrics(util::MetricsSnapshot& snapshot) const;
+
 		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
 
 		std::future<void> start_heartbeat(Lifetime lifetime);
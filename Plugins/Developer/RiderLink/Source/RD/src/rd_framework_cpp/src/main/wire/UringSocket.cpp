@@ -0,0 +1,394 @@
+#include "wire/UringSocket.h"
+
+#if defined(__linux__)
+
+#include "util/core_util.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace rd
+{
+namespace
+{
+int io_uring_setup(unsigned entries, io_uring_params* params)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args)
+{
+	return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+constexpr uint64_t READ_TAG = 1;
+constexpr uint64_t TIMEOUT_TAG = 2;
+constexpr uint64_t SEND_TAG = 3;
+}	 // namespace
+
+/**
+ * \brief Submission and completion queues of one io_uring instance mapped into this process.
+ */
+class UringSocket::Ring
+{
+	void* sq_ptr = MAP_FAILED;
+	size_t sq_size = 0;
+	void* cq_ptr = MAP_FAILED;
+	size_t cq_size = 0;
+	io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+	size_t sqes_size = 0;
+
+	unsigned* sq_head = nullptr;
+	unsigned* sq_tail = nullptr;
+	unsigned sq_mask = 0;
+	unsigned* sq_array = nullptr;
+
+	unsigned* cq_head = nullptr;
+	unsigned* cq_tail = nullptr;
+	unsigned cq_mask = 0;
+	io_uring_cqe* cqes = nullptr;
+
+public:
+	int fd = -1;
+
+	// kept here because the kernel reads them when the operation starts, not when it is submitted
+	__kernel_timespec timeout{};
+	iovec iov[4]{};
+	msghdr message{};
+
+	// region ctor/dtor
+
+	Ring() = default;
+
+	Ring(Ring const&) = delete;
+
+	Ring& operator=(Ring const&) = delete;
+
+	~Ring()
+	{
+		if (sqes != MAP_FAILED)
+		{
+			munmap(sqes, sqes_size);
+		}
+		if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+		{
+			munmap(cq_ptr, cq_size);
+		}
+		if (sq_ptr != MAP_FAILED)
+		{
+			munmap(sq_ptr, sq_size);
+		}
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+	}
+	// endregion
+
+	bool init(unsigned entries)
+	{
+		io_uring_params params{};
+		fd = io_uring_setup(entries, &params);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (single_mmap)
+		{
+			sq_size = cq_size = (std::max)(sq_size, cq_size);
+		}
+		sq_ptr = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		if (sq_ptr == MAP_FAILED)
+		{
+			return false;
+		}
+		cq_ptr = single_mmap ? sq_ptr
+							 : mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		if (cq_ptr == MAP_FAILED)
+		{
+			return false;
+		}
+		sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+		sqes = static_cast<io_uring_sqe*>(
+			mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+		if (sqes == MAP_FAILED)
+		{
+			return false;
+		}
+
+		auto* sq = static_cast<char*>(sq_ptr);
+		sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+		sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+		auto* cq = static_cast<char*>(cq_ptr);
+		cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		return true;
+	}
+
+	bool supports(std::initializer_list<int> opcodes) const
+	{
+		constexpr unsigned OPS = 256;
+		const size_t size = sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op);
+		auto* probe = static_cast<io_uring_probe*>(calloc(1, size));
+		bool result = io_uring_register(fd, IORING_REGISTER_PROBE, probe, OPS) == 0;
+		for (int opcode : opcodes)
+		{
+			result = result && opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+		}
+		free(probe);
+		return result;
+	}
+
+	bool register_buffer(void* data, size_t size)
+	{
+		iovec buffer{data, size};
+		return io_uring_register(fd, IORING_REGISTER_BUFFERS, &buffer, 1) == 0;
+	}
+
+	/**
+	 * \brief Entry for the next submission, rings are sized for all operations a call submits at once.
+	 */
+	io_uring_sqe* next_sqe()
+	{
+		const unsigned tail = *sq_tail;
+		const unsigned index = tail & sq_mask;
+		io_uring_sqe* sqe = &sqes[index];
+		memset(sqe, 0, sizeof(io_uring_sqe));
+		sq_array[index] = index;
+		__atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+		return sqe;
+	}
+
+	/**
+	 * \brief Submits all queued entries and waits for [count] completions, passing them to [on_completion].
+	 */
+	template <typename F>
+	bool submit_and_wait(unsigned count, F&& on_completion)
+	{
+		while (count > 0)
+		{
+			unsigned head = *cq_head;
+			const unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+			for (; head != tail && count > 0; ++head, --count)
+			{
+				on_completion(cqes[head & cq_mask]);
+			}
+			__atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+			if (count == 0)
+			{
+				break;
+			}
+
+			const unsigned to_submit = *sq_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+			if (io_uring_enter(fd, to_submit, count, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+UringSocket::UringSocket(int fd, std::unique_ptr<Ring> receive_ring, std::unique_ptr<Ring> send_ring)
+	: fd(fd), receive_ring(std::move(receive_ring)), send_ring(std::move(send_ring))
+{
+}
+
+UringSocket::~UringSocket() = default;
+
+std::unique_ptr<UringSocket> UringSocket::create(int fd, Buffer::word_t* receive_buffer, size_t receive_buffer_size)
+{
+	auto receive_ring = std::make_unique<Ring>();
+	auto send_ring = std::make_unique<Ring>();
+	if (!receive_ring->init(2) || !send_ring->init(1))
+	{
+		return nullptr;
+	}
+	if (!receive_ring->supports({IORING_OP_READ_FIXED, IORING_OP_READV, IORING_OP_LINK_TIMEOUT, IORING_OP_SENDMSG}))
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<UringSocket> result(new UringSocket(fd, std::move(receive_ring), std::move(send_ring)));
+	// without it (e.g. over the locked memory limit) receives are vectored reads into the same memory
+	if (result->receive_ring->register_buffer(receive_buffer, receive_buffer_size))
+	{
+		result->registered_buffer = receive_buffer;
+		result->registered_size = receive_buffer_size;
+	}
+	return result;
+}
+
+int32_t UringSocket::receive(Buffer::word_t* data, int32_t size, std::chrono::milliseconds timeout) const
+{
+	Ring& ring = *receive_ring;
+
+	io_uring_sqe* read = ring.next_sqe();
+	read->fd = fd;
+	read->addr = reinterpret_cast<uint64_t>(data);
+	read->len = static_cast<uint32_t>(size);
+	if (registered_size != 0 && data >= registered_buffer && data + size <= registered_buffer + registered_size)
+	{
+		read->opcode = IORING_OP_READ_FIXED;
+		read->buf_index = 0;
+	}
+	else
+	{
+		ring.iov[0] = iovec{data, static_cast<size_t>(size)};
+		read->opcode = IORING_OP_READV;
+		read->addr = reinterpret_cast<uint64_t>(&ring.iov[0]);
+		read->len = 1;
+	}
+	read->flags = IOSQE_IO_LINK;
+	read->user_data = READ_TAG;
+
+	ring.timeout.tv_sec = timeout.count() / 1000;
+	ring.timeout.tv_nsec = (timeout.count() % 1000) * 1000000;
+	io_uring_sqe* limit = ring.next_sqe();
+	limit->opcode = IORING_OP_LINK_TIMEOUT;
+	limit->fd = -1;
+	limit->addr = reinterpret_cast<uint64_t>(&ring.timeout);
+	limit->len = 1;
+	limit->user_data = TIMEOUT_TAG;
+
+	// the timeout completes too, cancelled or expired
+	int32_t result = -1;
+	if (!ring.submit_and_wait(2, [&result](io_uring_cqe const& cqe) {
+			if (cqe.user_data == READ_TAG)
+			{
+				result = cqe.res;
+			}
+		}))
+	{
+		return -1;
+	}
+	if (result >= 0)
+	{
+		return result;
+	}
+	if (result == -ECANCELED || result == -EINTR || result == -EAGAIN)
+	{
+		return TIMED_OUT;
+	}
+	errno = -result;
+	return -1;
+}
+
+bool UringSocket::send(std::initializer_list<Part> parts) const
+{
+	Ring& ring = *send_ring;
+	RD_ASSERT_MSG(parts.size() <= sizeof(ring.iov) / sizeof(ring.iov[0]), "too many parts to send at once");
+
+	int count = 0;
+	size_t rest = 0;
+	for (Part const& part : parts)
+	{
+		if (part.size > 0)
+		{
+			ring.iov[count++] = iovec{const_cast<Buffer::word_t*>(part.data), part.size};
+			rest += part.size;
+		}
+	}
+	iovec* first = ring.iov;
+	while (rest > 0)
+	{
+		ring.message = msghdr{};
+		ring.message.msg_iov = first;
+		ring.message.msg_iovlen = static_cast<size_t>(count - (first - ring.iov));
+
+		io_uring_sqe* sqe = ring.next_sqe();
+		sqe->opcode = IORING_OP_SENDMSG;
+		sqe->fd = fd;
+		sqe->addr = reinterpret_cast<uint64_t>(&ring.message);
+		sqe->len = 1;
+		sqe->msg_flags = MSG_NOSIGNAL;
+		sqe->user_data = SEND_TAG;
+
+		int32_t sent = -1;
+		if (!ring.submit_and_wait(1, [&sent](io_uring_cqe const& cqe) { sent = cqe.res; }))
+		{
+			return false;
+		}
+		if (sent == -EINTR || sent == -EAGAIN)
+		{
+			continue;
+		}
+		if (sent <= 0)
+		{
+			errno = -sent;
+			return false;
+		}
+
+		// a stream socket may take a part of the message, the rest goes in the next submission
+		rest -= static_cast<size_t>(sent);
+		size_t advance = static_cast<size_t>(sent);
+		while (advance > 0 && advance >= first->iov_len)
+		{
+			advance -= first->iov_len;
+			++first;
+		}
+		if (advance > 0)
+		{
+			first->iov_base = static_cast<char*>(first->iov_base) + advance;
+			first->iov_len -= advance;
+		}
+	}
+	return true;
+}
+}	 // namespace rd
+
+#else
+
+namespace rd
+{
+class UringSocket::Ring
+{
+};
+
+UringSocket::UringSocket(int fd, std::unique_ptr<Ring> receive_ring, std::unique_ptr<Ring> send_ring)
+	: fd(fd), receive_ring(std::move(receive_ring)), send_ring(std::move(send_ring))
+{
+}
+
+UringSocket::~UringSocket() = default;
+
+std::unique_ptr<UringSocket> UringSocket::create(int, Buffer::word_t*, size_t)
+{
+	return nullptr;
+}
+
+int32_t UringSocket::receive(Buffer::word_t*, int32_t, std::chrono::milliseconds) const
+{
+	return -1;
+}
+
+bool UringSocket::send(std::initializer_list<Part>) const
+{
+	return false;
+}
+}	 // namespace rd
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef RD_CPP_URINGSOCKET_H
+#define RD_CPP_URINGSOCKET_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "protocol/Buffer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Socket I/O of a connected stream socket through io_uring, available on Linux only.
+ *
+ * \details Receives complete in the buffer registered on creation (or directly in the caller's memory for large reads),
+ * with the wait for data and its timeout submitted together in one system call. A send gathers all its parts
+ * (e.g. package header and body) into one submission. Receive and send have rings of their own,
+ * so that the receiver thread and senders don't share submission state.
+ * [create] returns nullptr where io_uring isn't supported or allowed, callers keep using their socket then.
+ */
+class RD_FRAMEWORK_API UringSocket
+{
+	class Ring;
+
+	int fd;
+	std::unique_ptr<Ring> receive_ring;
+	std::unique_ptr<Ring> send_ring;
+
+	Buffer::word_t* registered_buffer = nullptr;
+	size_t registered_size = 0;
+
+	UringSocket(int fd, std::unique_ptr<Ring> receive_ring, std::unique_ptr<Ring> send_ring);
+
+public:
+	struct Part
+	{
+		Buffer::word_t const* data;
+		size_t size;
+	};
+
+	static constexpr int32_t TIMED_OUT = -2;
+
+	// region ctor/dtor
+
+	UringSocket(UringSocket const&) = delete;
+
+	UringSocket& operator=(UringSocket const&) = delete;
+
+	~UringSocket();
+	// endregion
+
+	/**
+	 * \brief Sets up rings for the socket [fd] and registers [receive_buffer] with the kernel.
+	 */
+	static std::unique_ptr<UringSocket> create(int fd, Buffer::word_t* receive_buffer, size_t receive_buffer_size);
+
+	/**
+	 * \brief Receives whatever is available, up to [size] bytes, waiting for it at most [timeout].
+	 * \return number of bytes received, 0 if the socket was shut down, [TIMED_OUT] or -1 on error.
+	 */
+	int32_t receive(Buffer::word_t* data, int32_t size, std::chrono::milliseconds timeout) const;
+
+	/**
+	 * \brief Sends all [parts] in order, one submission unless the socket accepts them partially.
+	 */
+	bool send(std::initializer_list<Part> parts) const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_URINGSOCKET_H
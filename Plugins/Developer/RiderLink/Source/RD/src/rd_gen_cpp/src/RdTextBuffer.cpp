@@ -1 +1,304 @@
 #include "RdTextBuffer.h"
+
+#include "base/IWire.h"
+
+namespace rd
+{
+std::string to_string(RdTextChange const& change)
+{
+	static const char* const kinds[] = {"Insert", "Remove", "Replace", "Reset"};
+	return std::string(kinds[static_cast<int8_t>(change.kind)]) + " at " + std::to_string(change.start_offset) +
+		   ": -" + std::to_string(change.old_text.size()) + " +" + std::to_string(change.new_text.size()) +
+		   " = " + std::to_string(change.full_text_length);
+}
+
+RdTextBuffer::RdTextBuffer(wstring_view initial_text) : text(initial_text)
+{
+}
+
+std::string RdTextBuffer::logmsg(TextBufferVersion const& v) const
+{
+	return "text buffer " + to_string(location) + " " + to_string(rdid) + ":: ver = " + to_string(v) +
+		   " :: local ver = " + to_string(version);
+}
+
+RdTextChange::Kind RdTextBuffer::kind_of(size_t removed, size_t inserted)
+{
+	if (removed == 0)
+	{
+		return RdTextChange::Kind::Insert;
+	}
+	return inserted == 0 ? RdTextChange::Kind::Remove : RdTextChange::Kind::Replace;
+}
+
+RdTextChange RdTextBuffer::apply(size_t offset, size_t count, wstring_view new_text) const
+{
+	std::wstring old_text = text.substr(offset, count);
+	text.replace(offset, count, new_text);
+	return RdTextChange{kind_of(old_text.size(), new_text.size()), static_cast<int32_t>(offset), std::move(old_text),
+		std::wstring(new_text.data(), new_text.size()), static_cast<int32_t>(text.size())};
+}
+
+void RdTextBuffer::send_edit(int32_t offset, int32_t count, wstring_view new_text) const
+{
+	get_wire()->send_inline(rdid, [&](Buffer& buffer) {
+		buffer.require_available(sizeof(int8_t) + 5 * sizeof(int32_t) + Buffer::wstring_size(new_text));
+		buffer.write_integral<int8_t>(static_cast<int8_t>(MessageKind::Edit));
+		buffer.write_integral<int32_t>(version.master);
+		buffer.write_integral<int32_t>(version.slave);
+		buffer.write_integral<int32_t>(offset);
+		buffer.write_integral<int32_t>(count);
+		buffer.write_wstring(new_text);
+		buffer.write_integral<int32_t>(static_cast<int32_t>(text.size()));
+		log_send()->trace("SEND{} :: edit at {} :: -{} +{}", logmsg(version), offset, count, new_text.size());
+	});
+}
+
+void RdTextBuffer::send_reset() const
+{
+	// slave edits based on the replaced text carry an older master version and get dropped
+	++version.master;
+	const std::wstring full_text = text.to_wstring();
+	get_wire()->send_inline(rdid, [&](Buffer& buffer) {
+		buffer.require_available(sizeof(int8_t) + 2 * sizeof(int32_t) + Buffer::wstring_size(full_text));
+		buffer.write_integral<int8_t>(static_cast<int8_t>(MessageKind::Reset));
+		buffer.write_integral<int32_t>(version.master);
+		buffer.write_integral<int32_t>(version.slave);
+		buffer.write_wstring(full_text);
+		log_send()->trace("SEND{} :: reset :: length = {}", logmsg(version), full_text.size());
+	});
+}
+
+void RdTextBuffer::send_version(MessageKind kind) const
+{
+	get_wire()->send_inline(rdid, [&](Buffer& buffer) {
+		buffer.write_integral<int8_t>(static_cast<int8_t>(kind));
+		buffer.write_integral<int32_t>(version.master);
+		buffer.write_integral<int32_t>(version.slave);
+	});
+}
+
+void RdTextBuffer::revert_unacknowledged(int32_t slave_version) const
+{
+	while (!unacknowledged.empty() && unacknowledged.back().slave_version > slave_version)
+	{
+		PendingEdit edit = std::move(unacknowledged.back());
+		unacknowledged.pop_back();
+		change_signal.fire(apply(edit.start_offset, edit.new_length, edit.old_text));
+	}
+}
+
+void RdTextBuffer::forget_acknowledged(int32_t slave_version) const
+{
+	while (!unacknowledged.empty() && unacknowledged.front().slave_version <= slave_version)
+	{
+		unacknowledged.pop_front();
+	}
+}
+
+void RdTextBuffer::receive_edit(Buffer& buffer, TextBufferVersion const& remote) const
+{
+	const int32_t offset = buffer.read_integral<int32_t>();
+	const int32_t count = buffer.read_integral<int32_t>();
+	const std::wstring new_text = buffer.read_wstring();
+	const int32_t full_text_length = buffer.read_integral<int32_t>();
+
+	if (is_master)
+	{
+		if (remote.master != version.master)
+		{
+			// the slave hasn't seen our latest edits, it reverts this one on receiving them
+			log_received()->trace("RECV{} :: edit at {} >> REJECTED", logmsg(remote), offset);
+			return;
+		}
+		version.slave = remote.slave;
+	}
+	else
+	{
+		// master versions newer than ours are fine, our edits it hasn't seen were dropped by it
+		revert_unacknowledged(remote.slave);
+		forget_acknowledged(remote.slave);
+		version = remote;
+	}
+
+	log_received()->trace("RECV{} :: edit at {} :: -{} +{}", logmsg(remote), offset, count, new_text.size());
+	const bool in_range = offset >= 0 && count >= 0 && static_cast<size_t>(offset) + count <= text.size();
+	if (in_range)
+	{
+		RdTextChange change = apply(offset, count, new_text);
+		if (is_master)
+		{
+			send_version(MessageKind::Ack);
+		}
+		change_signal.fire(change);
+	}
+	if (!in_range || static_cast<int32_t>(text.size()) != full_text_length)
+	{
+		log_received()->error("{} :: text length {} doesn't match edit, resynchronizing", logmsg(remote), text.size());
+		if (is_master)
+		{
+			send_reset();
+		}
+		else
+		{
+			send_version(MessageKind::ResyncRequest);
+		}
+	}
+}
+
+void RdTextBuffer::receive_reset(Buffer& buffer, TextBufferVersion const& remote) const
+{
+	std::wstring new_text = buffer.read_wstring();
+	if (is_master)
+	{
+		log_received()->error("Both ends are masters: {}", to_string(location));
+		return;
+	}
+	log_received()->trace("RECV{} :: reset :: length = {}", logmsg(remote), new_text.size());
+	unacknowledged.clear();
+	version = remote;
+	RdTextChange change = apply(0, text.size(), new_text);
+	change.kind = RdTextChange::Kind::Reset;
+	change_signal.fire(change);
+}
+
+RdTextBuffer RdTextBuffer::read(SerializationCtx& /*ctx*/, Buffer& buffer)
+{
+	RdTextBuffer res;
+	const RdId& id = RdId::read(buffer);
+	withId(res, id);
+	return res;
+}
+
+void RdTextBuffer::write(SerializationCtx& /*ctx*/, Buffer& buffer) const
+{
+	rdid.write(buffer);
+}
+
+void RdTextBuffer::init(Lifetime lifetime) const
+{
+	RdReactiveBase::init(lifetime);
+	get_wire()->advise(lifetime, this);
+	if (is_master)
+	{
+		send_reset();
+	}
+}
+
+void RdTextBuffer::on_wire_received(Buffer buffer) const
+{
+	const auto kind = static_cast<MessageKind>(buffer.read_integral<int8_t>());
+	TextBufferVersion remote;
+	remote.master = buffer.read_integral<int32_t>();
+	remote.slave = buffer.read_integral<int32_t>();
+
+	switch (kind)
+	{
+		case MessageKind::Edit:
+			receive_edit(buffer, remote);
+			break;
+		case MessageKind::Reset:
+			receive_reset(buffer, remote);
+			break;
+		case MessageKind::Ack:
+			log_received()->trace("RECV{} :: ack", logmsg(remote));
+			forget_acknowledged(remote.slave);
+			break;
+		case MessageKind::ResyncRequest:
+			log_received()->trace("RECV{} :: resync request", logmsg(remote));
+			if (is_master)
+			{
+				send_reset();
+			}
+			break;
+	}
+}
+
+TextRope const& RdTextBuffer::get_text() const
+{
+	return text;
+}
+
+std::wstring RdTextBuffer::to_wstring() const
+{
+	return text.to_wstring();
+}
+
+size_t RdTextBuffer::size() const
+{
+	return text.size();
+}
+
+TextBufferVersion RdTextBuffer::get_version() const
+{
+	return version;
+}
+
+void RdTextBuffer::replace(size_t offset, size_t count, wstring_view new_text)
+{
+	RD_ASSERT_THROW_MSG(offset + count <= text.size(), "RdTextBuffer::replace: range " + std::to_string(offset) + ".." +
+														   std::to_string(offset + count) + " is out of text of " +
+														   std::to_string(text.size()) + " characters");
+	local_change([&] {
+		if (!is_bound())
+		{
+			change_signal.fire(apply(offset, count, new_text));
+			return;
+		}
+		if (is_master)
+		{
+			++version.master;
+		}
+		else
+		{
+			++version.slave;
+		}
+		RdTextChange change = apply(offset, count, new_text);
+		if (!is_master)
+		{
+			unacknowledged.push_back(PendingEdit{version.slave, change.start_offset, change.old_text, static_cast<int32_t>(new_text.size())});
+		}
+		send_edit(static_cast<int32_t>(offset), static_cast<int32_t>(count), new_text);
+		change_signal.fire(change);
+	});
+}
+
+void RdTextBuffer::insert(size_t offset, wstring_view new_text)
+{
+	replace(offset, 0, new_text);
+}
+
+void RdTextBuffer::remove(size_t offset, size_t count)
+{
+	replace(offset, count, wstring_view());
+}
+
+void RdTextBuffer::reset(wstring_view new_text)
+{
+	if (!is_master || !is_bound())
+	{
+		replace(0, text.size(), new_text);
+		return;
+	}
+	local_change([&] {
+		RdTextChange change = apply(0, text.size(), new_text);
+		change.kind = RdTextChange::Kind::Reset;
+		send_reset();
+		change_signal.fire(change);
+	});
+}
+
+void RdTextBuffer::advise(Lifetime lifetime, std::function<void(RdTextChange const&)> handler) const
+{
+	if (is_bound())
+	{
+		assert_threading();
+	}
+	change_signal.advise(lifetime, std::move(handler));
+}
+
+std::string to_string(RdTextBuffer const& value)
+{
+	return "text buffer of " + std::to_string(value.size()) + " characters, ver = " + to_string(value.get_version());
+}
+}	 // namespace rd
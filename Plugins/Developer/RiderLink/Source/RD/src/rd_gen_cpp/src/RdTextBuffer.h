@@ -1,11 +1,195 @@
 #ifndef RD_CPP_RDTEXTBUFFER_H
 #define RD_CPP_RDTEXTBUFFER_H
 
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4250)
+#pragma warning(disable : 4251)
+#endif
+
+#include "TextRope.h"
+
+#include "base/RdReactiveBase.h"
+#include "reactive/base/SignalX.h"
+#include "serialization/ISerializable.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include <rd_framework_export.h>
+
 namespace rd
 {
-class RdTextBuffer
+/**
+ * \brief Pair of edit counters of both sides, each side increments its own counter on local edits.
+ */
+struct TextBufferVersion
+{
+	int32_t master = 0;
+	int32_t slave = 0;
+
+	friend bool operator==(TextBufferVersion const& lhs, TextBufferVersion const& rhs)
+	{
+		return lhs.master == rhs.master && lhs.slave == rhs.slave;
+	}
+
+	friend bool operator!=(TextBufferVersion const& lhs, TextBufferVersion const& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	friend std::string to_string(TextBufferVersion const& version)
+	{
+		return "(" + std::to_string(version.master) + ", " + std::to_string(version.slave) + ")";
+	}
+};
+
+/**
+ * \brief Edit of RdTextBuffer: [old_text] at [start_offset] was replaced by [new_text], the text has
+ * [full_text_length] characters afterwards.
+ */
+struct RdTextChange
 {
+	enum class Kind : int8_t
+	{
+		Insert,
+		Remove,
+		Replace,
+		// the whole text was replaced
+		Reset
+	};
+
+	Kind kind;
+	int32_t start_offset;
+	std::wstring old_text;
+	std::wstring new_text;
+	int32_t full_text_length;
+
+	friend std::string to_string(RdTextChange const& change);
+};
+
+/**
+ * \brief Text document synchronized through wire by edit deltas.
+ *
+ * \details The text lives in a TextRope, so edits of large documents cost O(log n). Every edit is sent as
+ * (start offset, removed length, inserted text) together with the TextBufferVersion it produced,
+ * the removed text is taken from the receiver's copy.
+ *
+ * Conflicts are resolved in favour of the master. The master drops slave edits made on top of a master version
+ * the slave hasn't seen yet, and acknowledges the edits it applies. The slave keeps its unacknowledged edits and,
+ * when a master edit shows they were dropped, reverts them before applying the master edit. Both sides
+ * then converge to the master's text.
+ *
+ * The master sends its whole text on bind and it replaces the text of the slave.
+ * A receiver whose text length doesn't match the one of an edit asks the master for the whole text.
+ */
+class RD_FRAMEWORK_API RdTextBuffer final : public RdReactiveBase, public ISerializable
+{
+private:
+	enum class MessageKind : int8_t
+	{
+		Edit,
+		Reset,
+		Ack,
+		ResyncRequest
+	};
+
+	// edit of the slave which the master hasn't acknowledged yet
+	struct PendingEdit
+	{
+		int32_t slave_version;
+		int32_t start_offset;
+		std::wstring old_text;
+		int32_t new_length;
+	};
+
+	mutable TextRope text;
+
+	mutable TextBufferVersion version;
+
+	mutable std::deque<PendingEdit> unacknowledged;
+
+	Signal<RdTextChange> change_signal;
+
+	std::string logmsg(TextBufferVersion const& v) const;
+
+	static RdTextChange::Kind kind_of(size_t removed, size_t inserted);
+
+	RdTextChange apply(size_t offset, size_t count, wstring_view new_text) const;
+
+	void send_edit(int32_t offset, int32_t count, wstring_view new_text) const;
+
+	void send_reset() const;
+
+	void send_version(MessageKind kind) const;
+
+	void revert_unacknowledged(int32_t slave_version) const;
+
+	void forget_acknowledged(int32_t slave_version) const;
+
+	void receive_edit(Buffer& buffer, TextBufferVersion const& remote) const;
+
+	void receive_reset(Buffer& buffer, TextBufferVersion const& remote) const;
+
+public:
+	bool is_master = false;
+
+	// region ctor/dtor
+
+	RdTextBuffer() = default;
+
+	explicit RdTextBuffer(wstring_view initial_text);
+
+	RdTextBuffer(RdTextBuffer&&) = default;
+
+	RdTextBuffer& operator=(RdTextBuffer&&) = default;
+
+	virtual ~RdTextBuffer() = default;
+	// endregion
+
+	static RdTextBuffer read(SerializationCtx& ctx, Buffer& buffer);
+
+	void write(SerializationCtx& ctx, Buffer& buffer) const override;
+
+	void init(Lifetime lifetime) const override;
+
+	void on_wire_received(Buffer buffer) const override;
+
+	TextRope const& get_text() const;
+
+	std::wstring to_wstring() const;
+
+	size_t size() const;
+
+	TextBufferVersion get_version() const;
+
+	/**
+	 * \brief Replaces [count] characters at [offset] by [new_text] and sends the edit to the other side.
+	 */
+	void replace(size_t offset, size_t count, wstring_view new_text);
+
+	void insert(size_t offset, wstring_view new_text);
+
+	void remove(size_t offset, size_t count);
+
+	/**
+	 * \brief Replaces the whole text. Only the master sends it, a slave reset is an ordinary edit.
+	 */
+	void reset(wstring_view new_text);
+
+	/**
+	 * \brief [handler] is called for local and remote edits after they are applied, reverted slave edits
+	 * are reported as edits too.
+	 */
+	void advise(Lifetime lifetime, std::function<void(RdTextChange const&)> handler) const;
+
+	friend std::string to_string(RdTextBuffer const& value);
 };
 }	 // namespace rd
 
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
 #endif	  // RD_CPP_RDTEXTBUFFER_H
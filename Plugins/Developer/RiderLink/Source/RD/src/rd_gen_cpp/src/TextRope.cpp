@@ -0,0 +1,278 @@
+#include "TextRope.h"
+
+#include "util/core_util.h"
+
+#include <algorithm>
+
+namespace rd
+{
+TextRope::Node::Node(std::wstring chunk, uint32_t priority) : chunk(std::move(chunk)), length(this->chunk.size()), priority(priority)
+{
+}
+
+TextRope::TextRope(wstring_view text)
+{
+	root = make_nodes(text);
+}
+
+TextRope::~TextRope() = default;
+
+uint32_t TextRope::next_priority()
+{
+	// xorshift32, priorities only have to be independent of the text
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+size_t TextRope::length_of(node_ptr const& node)
+{
+	return node ? node->length : 0;
+}
+
+void TextRope::update(Node* node)
+{
+	node->length = length_of(node->left) + node->chunk.size() + length_of(node->right);
+}
+
+TextRope::node_ptr TextRope::merge(node_ptr a, node_ptr b)
+{
+	if (!a)
+	{
+		return b;
+	}
+	if (!b)
+	{
+		return a;
+	}
+	if (a->priority > b->priority)
+	{
+		a->right = merge(std::move(a->right), std::move(b));
+		update(a.get());
+		return a;
+	}
+	b->left = merge(std::move(a), std::move(b->left));
+	update(b.get());
+	return b;
+}
+
+std::pair<TextRope::node_ptr, TextRope::node_ptr> TextRope::split(node_ptr node, size_t offset)
+{
+	if (!node)
+	{
+		return {};
+	}
+	const size_t left_length = length_of(node->left);
+	if (offset <= left_length)
+	{
+		auto parts = split(std::move(node->left), offset);
+		node->left = std::move(parts.second);
+		update(node.get());
+		return {std::move(parts.first), std::move(node)};
+	}
+	if (offset >= left_length + node->chunk.size())
+	{
+		auto parts = split(std::move(node->right), offset - left_length - node->chunk.size());
+		node->right = std::move(parts.first);
+		update(node.get());
+		return {std::move(node), std::move(parts.second)};
+	}
+	// the offset is inside of the chunk: its tail becomes a node of the right part
+	const size_t inner = offset - left_length;
+	node_ptr tail = std::make_unique<Node>(node->chunk.substr(inner), next_priority());
+	node->chunk.resize(inner);
+	node_ptr right = std::move(node->right);
+	update(node.get());
+	return {std::move(node), merge(std::move(tail), std::move(right))};
+}
+
+TextRope::node_ptr TextRope::make_nodes(wstring_view text)
+{
+	node_ptr result;
+	for (size_t start = 0; start < text.size(); start += MAX_CHUNK)
+	{
+		const size_t count = (std::min)(MAX_CHUNK, text.size() - start);
+		result = merge(std::move(result), std::make_unique<Node>(std::wstring(text.data() + start, count), next_priority()));
+	}
+	return result;
+}
+
+std::pair<TextRope::Node*, size_t> TextRope::locate(size_t offset) const
+{
+	Node* node = root.get();
+	while (node)
+	{
+		const size_t left_length = length_of(node->left);
+		if (offset < left_length)
+		{
+			node = node->left.get();
+		}
+		else if (offset <= left_length + node->chunk.size())
+		{
+			return {node, offset - left_length};
+		}
+		else
+		{
+			offset -= left_length + node->chunk.size();
+			node = node->right.get();
+		}
+	}
+	return {nullptr, 0};
+}
+
+void TextRope::adjust_path(size_t offset, size_t delta, bool grow)
+{
+	// must descend exactly like locate
+	Node* node = root.get();
+	while (node)
+	{
+		const size_t left_length = length_of(node->left);
+		node->length = grow ? node->length + delta : node->length - delta;
+		if (offset < left_length)
+		{
+			node = node->left.get();
+		}
+		else if (offset <= left_length + node->chunk.size())
+		{
+			return;
+		}
+		else
+		{
+			offset -= left_length + node->chunk.size();
+			node = node->right.get();
+		}
+	}
+}
+
+void TextRope::append(Node const* node, size_t from, size_t to, std::wstring& out)
+{
+	while (node && from < to)
+	{
+		const size_t left_length = length_of(node->left);
+		if (from < left_length)
+		{
+			append(node->left.get(), from, (std::min)(to, left_length), out);
+		}
+		const size_t chunk_end = left_length + node->chunk.size();
+		if (to > left_length && from < chunk_end)
+		{
+			const size_t start = (std::max)(from, left_length);
+			out.append(node->chunk, start - left_length, (std::min)(to, chunk_end) - start);
+		}
+		if (to <= chunk_end)
+		{
+			return;
+		}
+		from = from > chunk_end ? from - chunk_end : 0;
+		to -= chunk_end;
+		node = node->right.get();
+	}
+}
+
+size_t TextRope::size() const
+{
+	return length_of(root);
+}
+
+bool TextRope::empty() const
+{
+	return !root || root->length == 0;
+}
+
+wchar_t TextRope::at(size_t offset) const
+{
+	RD_ASSERT_THROW_MSG(offset < size(), "TextRope::at: offset " + std::to_string(offset) + " is out of range");
+	Node const* node = root.get();
+	while (true)
+	{
+		const size_t left_length = length_of(node->left);
+		if (offset < left_length)
+		{
+			node = node->left.get();
+		}
+		else if (offset < left_length + node->chunk.size())
+		{
+			return node->chunk[offset - left_length];
+		}
+		else
+		{
+			offset -= left_length + node->chunk.size();
+			node = node->right.get();
+		}
+	}
+}
+
+std::wstring TextRope::substr(size_t offset, size_t count) const
+{
+	std::wstring result;
+	if (offset >= size())
+	{
+		return result;
+	}
+	count = (std::min)(count, size() - offset);
+	result.reserve(count);
+	append(root.get(), offset, offset + count, result);
+	return result;
+}
+
+std::wstring TextRope::to_wstring() const
+{
+	return substr(0, size());
+}
+
+void TextRope::insert(size_t offset, wstring_view text)
+{
+	RD_ASSERT_THROW_MSG(offset <= size(), "TextRope::insert: offset " + std::to_string(offset) + " is out of range");
+	if (text.empty())
+	{
+		return;
+	}
+	auto location = locate(offset);
+	if (location.first && location.first->chunk.size() + text.size() <= MAX_CHUNK)
+	{
+		adjust_path(offset, text.size(), true);
+		location.first->chunk.insert(location.second, text.data(), text.size());
+		return;
+	}
+	auto parts = split(std::move(root), offset);
+	root = merge(merge(std::move(parts.first), make_nodes(text)), std::move(parts.second));
+}
+
+void TextRope::erase(size_t offset, size_t count)
+{
+	RD_ASSERT_THROW_MSG(offset <= size(), "TextRope::erase: offset " + std::to_string(offset) + " is out of range");
+	count = (std::min)(count, size() - offset);
+	if (count == 0)
+	{
+		return;
+	}
+	auto location = locate(offset);
+	if (location.second + count <= location.first->chunk.size() && count < location.first->chunk.size())
+	{
+		// leaves a non-empty chunk in place
+		adjust_path(offset, count, false);
+		location.first->chunk.erase(location.second, count);
+		return;
+	}
+	auto head = split(std::move(root), offset);
+	auto tail = split(std::move(head.second), count);
+	root = merge(std::move(head.first), std::move(tail.second));
+}
+
+void TextRope::replace(size_t offset, size_t count, wstring_view text)
+{
+	erase(offset, count);
+	insert(offset, text);
+}
+
+void TextRope::assign(wstring_view text)
+{
+	root = make_nodes(text);
+}
+
+void TextRope::clear()
+{
+	root.reset();
+}
+}	 // namespace rd
@@ -0,0 +1,125 @@
+#ifndef RD_CPP_TEXTROPE_H
+#define RD_CPP_TEXTROPE_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable : 4251)
+#endif
+
+#include "thirdparty.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Text stored as a sequence of chunks in an implicit treap ordered by offset.
+ *
+ * \details Insertion, removal and access by offset take O(log n) expected time plus the size of a chunk, so that
+ * editing multi-megabyte documents doesn't move the whole text. Small edits are made inside the chunk they touch,
+ * larger ones split the treap at the edit boundaries. Offsets are in wchar_t units.
+ */
+class RD_FRAMEWORK_API TextRope
+{
+public:
+	/**
+	 * \brief Chunks don't grow beyond this size by in-place edits, inserted text is cut into pieces of this size.
+	 */
+	static constexpr size_t MAX_CHUNK = 1024;
+
+private:
+	struct Node
+	{
+		std::wstring chunk;
+		// number of characters in the subtree
+		size_t length;
+		uint32_t priority;
+		std::unique_ptr<Node> left;
+		std::unique_ptr<Node> right;
+
+		Node(std::wstring chunk, uint32_t priority);
+	};
+
+	using node_ptr = std::unique_ptr<Node>;
+
+	node_ptr root;
+
+	uint32_t seed = 0x9E3779B9u;
+
+	uint32_t next_priority();
+
+	static size_t length_of(node_ptr const& node);
+
+	static void update(Node* node);
+
+	static node_ptr merge(node_ptr a, node_ptr b);
+
+	std::pair<node_ptr, node_ptr> split(node_ptr node, size_t offset);
+
+	node_ptr make_nodes(wstring_view text);
+
+	/**
+	 * \return node holding [offset] (or ending at it) and the offset inside its chunk
+	 */
+	std::pair<Node*, size_t> locate(size_t offset) const;
+
+	/**
+	 * \brief Adds [delta] to the lengths on the path from the root to the chunk holding [offset].
+	 */
+	void adjust_path(size_t offset, size_t delta, bool grow);
+
+	static void append(Node const* node, size_t from, size_t to, std::wstring& out);
+
+public:
+	// region ctor/dtor
+
+	TextRope() = default;
+
+	explicit TextRope(wstring_view text);
+
+	TextRope(TextRope const&) = delete;
+
+	TextRope& operator=(TextRope const&) = delete;
+
+	TextRope(TextRope&&) = default;
+
+	TextRope& operator=(TextRope&&) = default;
+
+	~TextRope();
+	// endregion
+
+	size_t size() const;
+
+	bool empty() const;
+
+	wchar_t at(size_t offset) const;
+
+	/**
+	 * \return [count] characters starting at [offset], clipped to the end of the text
+	 */
+	std::wstring substr(size_t offset, size_t count) const;
+
+	std::wstring to_wstring() const;
+
+	void insert(size_t offset, wstring_view text);
+
+	void erase(size_t offset, size_t count);
+
+	void replace(size_t offset, size_t count, wstring_view text);
+
+	void assign(wstring_view text);
+
+	void clear();
+};
+}	 // namespace rd
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_TEXTROPE_H
@@ -1,5 +1,7 @@
 #include "ProtocolFactory.h"
 
+#include "RiderLink.hpp"
+
 #include "scheduler/base/IScheduler.h"
 #include "wire/SocketWire.h"
 
@@ -26,7 +28,12 @@
 #include "Windows/HideWindowsPlatformTypes.h"
 #endif
 
-#include "spdlog/sinks/daily_file_sink.h"
+#include "util/MappedFileSink.h"
+#include "wire/ProtocolTrace.h"
+
+#include "spdlog/sinks/basic_file_sink.h"
+
+#include <vector>
 
 static FString GetLocalAppdataFolder()
 {
@@ -72,6 +79,14 @@ static FString GetLogFile(const FString& projectName)
     return FPaths::Combine(*MiscFilesFolder, TEXT("Logs"), projectName + TEXT(".uproject"));
 }
 
+#if defined(ENABLE_PROTOCOL_TRACE) && ENABLE_PROTOCOL_TRACE == 1
+static FString GetProtocolTraceFile(const FString& projectName)
+{
+    const FString MiscFilesFolder = GetMiscFilesFolder();
+    return FPaths::Combine(*MiscFilesFolder, TEXT("Logs"), projectName + TEXT(".rdtrace"));
+}
+#endif
+
 ProtocolFactory::ProtocolFactory(const FString& ProjectName): ProjectName(ProjectName)
 {
     InitRdLogging();
@@ -82,8 +97,9 @@ void ProtocolFactory::InitRdLogging()
     spdlog::set_level(spdlog::level::err);
 #if defined(ENABLE_LOG_FILE) && ENABLE_LOG_FILE == 1
     const FString LogFile = GetLogFile(ProjectName);
-    const FString Msg = TEXT("[RiderLink] Path to log file: ") + LogFile;
-    auto FileLogger = std::make_shared<spdlog::sinks::daily_file_sink_mt>(*LogFile, 23, 59);
+    auto FileLogger = std::make_shared<rd::util::MappedFileSink>(*LogFile);
+    // segments are numbered on from those of earlier sessions, so the file written to differs from LogFile
+    UE_LOG(FLogRiderLinkModule, Log, TEXT("[RiderLink] Path to log file: %s"), *FString(FileLogger->filename().c_str()));
     FileLogger->set_level(spdlog::level::trace);
     spdlog::apply_all([FileLogger](std::shared_ptr<spdlog::logger> Logger)
     {
@@ -94,9 +110,15 @@ void ProtocolFactory::InitRdLogging()
 
 std::shared_ptr<rd::SocketWire::Server> ProtocolFactory::CreateWire(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime)
 {
-    return std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0,
+    auto Wire = std::make_shared<rd::SocketWire::Server>(SocketLifetime, Scheduler, 0,
                                                          TCHAR_TO_UTF8(*FString::Printf(TEXT("UnrealEditorServer-%s"),
                                                              *ProjectName)));
+#if defined(ENABLE_PROTOCOL_TRACE) && ENABLE_PROTOCOL_TRACE == 1
+    const FString TraceFile = GetProtocolTraceFile(ProjectName);
+    // the oldest segments are deleted, so the trace works as a ring of the recent traffic
+    Wire->set_trace(std::make_shared<rd::ProtocolTrace>(*TraceFile));
+#endif
+    return Wire;
 }
 
 
@@ -117,3 +139,36 @@ TUniquePtr<rd::Protocol> ProtocolFactory::CreateProtocol(rd::IScheduler* Schedul
     }
     return protocol;
 }
+
+int32 ProtocolFactory::DecodeProtocolTrace(const FString& TraceFile, const FString& OutputFile,
+                                           TFunction<std::shared_ptr<void>(rd::Lifetime, rd::IProtocol const*)> BindModel) const
+{
+    rd::ProtocolTraceReader Reader = rd::ProtocolTraceReader::open(*TraceFile);
+    if (!Reader.valid())
+    {
+        return INDEX_NONE;
+    }
+
+    auto Output = std::make_shared<spdlog::sinks::basic_file_sink_mt>(*OutputFile, true);
+    Output->set_pattern("%v");
+    auto Messages = std::make_shared<spdlog::logger>("protocolTrace", Output);
+    Messages->set_level(spdlog::level::trace);
+
+    // unbound by the replay, so they outlive it
+    std::vector<std::shared_ptr<void>> Models;
+    rd::ProtocolTraceReplay Replay(rd::Identities::SERVER);
+    // entities render what they deserialize in the traces of their protocol, the global loggers are left alone
+    Replay.local_protocol->set_loggers(Messages, Messages);
+    Replay.remote_protocol->set_loggers(Messages, Messages);
+    Replay.local_protocol->get_scheduler()->queue([&]()
+    {
+        Models.push_back(BindModel(Replay.lifetime, Replay.local_protocol.get()));
+        Models.push_back(BindModel(Replay.lifetime, Replay.remote_protocol.get()));
+    });
+
+    const size_t Count = Replay.replay_all(Reader, [&](rd::ProtocolTrace::Record const& Record)
+    {
+        Messages->info(Replay.describe(Record));
+    });
+    return static_cast<int32>(Count);
+}
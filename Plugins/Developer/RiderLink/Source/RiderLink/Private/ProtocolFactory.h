@@ -4,6 +4,7 @@
 #include "wire/SocketWire.h"
 
 #include "Containers/UnrealString.h"
+#include "Templates/Function.h"
 #include "Templates/UniquePtr.h"
 
 class ProtocolFactory
@@ -15,6 +16,11 @@ public:
 	TUniquePtr<rd::Protocol> CreateProtocol(rd::IScheduler* Scheduler, rd::Lifetime SocketLifetime,
 	                                        std::shared_ptr<rd::SocketWire::Server> wire);
 
+	// Renders a protocol trace segment into OutputFile: a line per message, then what the entity it was sent to
+	// deserialized, in models bound by BindModel. Returns the number of messages or INDEX_NONE if TraceFile isn't a trace.
+	int32 DecodeProtocolTrace(const FString& TraceFile, const FString& OutputFile,
+	                          TFunction<std::shared_ptr<void>(rd::Lifetime, rd::IProtocol const*)> BindModel) const;
+
 private:
 	void InitRdLogging();
 
@@ -3,6 +3,9 @@
 #include "ProtocolFactory.h"
 #include "UE4Library/UE4Library.Generated.h"
 
+#include "util/Metrics.h"
+
+#include "HAL/IConsoleManager.h"
 #include "Misc/App.h"
 #include "Misc/ScopeRWLock.h"
 #include "Modules/ModuleManager.h"
@@ -22,9 +25,30 @@ static FString GetProjectName()
 	return ProjectNameNoExtension;
 }
 
+// Keep small interactive messages from queueing behind the log stream
+static void SetSendPriorities(rd::Lifetime Lifetime, rd::IWire const& Wire,
+                              JetBrains::EditorPlugin::RdEditorModel const& Model)
+{
+	auto IdOf = [](auto const& Entity) { return dynamic_cast<rd::IRdBindable const&>(Entity).get_id(); };
+	Wire.set_priority(Lifetime, IdOf(Model.get_unrealLog()), rd::SendPriority::Bulk);
+	Wire.set_priority(Lifetime, IdOf(Model.get_allowSetForegroundWindow()), rd::SendPriority::High);
+	Wire.set_priority(Lifetime, IdOf(Model.get_playStateFromEditor()), rd::SendPriority::High);
+	Wire.set_priority(Lifetime, IdOf(Model.get_notificationReplyFromEditor()), rd::SendPriority::High);
+}
+
 void FRiderLinkModule::ShutdownModule()
 {
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN START"));
+	if (DecodeProtocolTraceCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(DecodeProtocolTraceCommand);
+		DecodeProtocolTraceCommand = nullptr;
+	}
+	if (RdMetricsCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(RdMetricsCommand);
+		RdMetricsCommand = nullptr;
+	}
 	ModuleLifetimeDef.terminate();
 	ProtocolFactory.Reset();
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink SHUTDOWN FINISH"));
@@ -34,6 +58,14 @@ void FRiderLinkModule::StartupModule()
 {
 	UE_LOG(FLogRiderLinkModule, Verbose, TEXT("RiderLink STARTUP START"));
 	ProtocolFactory = MakeUnique<class ProtocolFactory>(GetProjectName());
+	DecodeProtocolTraceCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("RiderLink.DecodeProtocolTrace"),
+		TEXT("Renders a RiderLink protocol trace segment as text. Usage: RiderLink.DecodeProtocolTrace <trace file> [output file]"),
+		FConsoleCommandWithArgsDelegate::CreateRaw(this, &FRiderLinkModule::DecodeProtocolTrace));
+	RdMetricsCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("RiderLink.RdMetrics"),
+		TEXT("Logs counters of the RiderLink protocol, or turns counting on or off. Usage: RiderLink.RdMetrics [on|off]"),
+		FConsoleCommandWithArgsDelegate::CreateRaw(this, &FRiderLinkModule::RdMetrics));
 	Scheduler.queue([this]()
 	{
 		InitProtocol();
@@ -67,6 +99,7 @@ void FRiderLinkModule::InitProtocol()
 			FRWScopeLock LockOnConnect(ModelLock, SLT_Write);
 			EditorModel = MakeUnique<JetBrains::EditorPlugin::RdEditorModel>();
 			EditorModel->connect(ConnectionLifetime, Protocol.Get());
+			SetSendPriorities(ConnectionLifetime, *Protocol->wire, *EditorModel);
 			JetBrains::EditorPlugin::UE4Library::serializersOwner.registerSerializersCore(
 				EditorModel->get_serialization_context().get_serializers()
 			);
@@ -94,6 +127,47 @@ void FRiderLinkModule::InitProtocol()
 
 bool FRiderLinkModule::SupportsDynamicReloading() { return true; }
 
+void FRiderLinkModule::DecodeProtocolTrace(const TArray<FString>& Args)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(FLogRiderLinkModule, Error, TEXT("Usage: RiderLink.DecodeProtocolTrace <trace file> [output file]"));
+		return;
+	}
+	const FString& TraceFile = Args[0];
+	const FString OutputFile = Args.Num() > 1 ? Args[1] : TraceFile + TEXT(".txt");
+	const int32 Count = ProtocolFactory->DecodeProtocolTrace(TraceFile, OutputFile,
+		[](rd::Lifetime Lifetime, rd::IProtocol const* TraceProtocol) -> std::shared_ptr<void>
+		{
+			auto Model = std::make_shared<JetBrains::EditorPlugin::RdEditorModel>();
+			Model->connect(Lifetime, TraceProtocol);
+			JetBrains::EditorPlugin::UE4Library::serializersOwner.registerSerializersCore(
+				Model->get_serialization_context().get_serializers()
+			);
+			return Model;
+		});
+	if (Count == INDEX_NONE)
+	{
+		UE_LOG(FLogRiderLinkModule, Error, TEXT("%s is not a RiderLink protocol trace"), *TraceFile);
+		return;
+	}
+	UE_LOG(FLogRiderLinkModule, Display, TEXT("Decoded %d messages of %s to %s"), Count, *TraceFile, *OutputFile);
+}
+
+void FRiderLinkModule::RdMetrics(const TArray<FString>& Args)
+{
+	if (Args.Num() > 0)
+	{
+		const bool Enable = Args[0] == TEXT("on");
+		rd::util::MetricsRegistry::enabled = Enable;
+		UE_LOG(FLogRiderLinkModule, Display, TEXT("RD metrics are %s"), Enable ? TEXT("on") : TEXT("off"));
+		return;
+	}
+	// gauges are reported either way, counters only grow while counting is on
+	const std::string Json = rd::util::MetricsRegistry::instance().snapshot().to_json();
+	UE_LOG(FLogRiderLinkModule, Display, TEXT("%s"), UTF8_TO_TCHAR(Json.c_str()));
+}
+
 
 // Can't place RdEditorModel or TUniquePtr<RdEditorModel> into RdProperty.
 // Have to resort to RdProperty<bool> and change it before creating new RdEditorModel
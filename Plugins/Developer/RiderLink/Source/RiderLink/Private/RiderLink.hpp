@@ -12,6 +12,7 @@
 
 #include "RdEditorModel/RdEditorModel.Generated.h"
 
+class IConsoleObject;
 class ProtocolFactory;
 
 namespace rd
@@ -46,6 +47,10 @@ public:
 private:
 	void InitProtocol();
 
+	void DecodeProtocolTrace(const TArray<FString>& Args);
+
+	void RdMetrics(const TArray<FString>& Args);
+
 	rd::LifetimeDefinition ModuleLifetimeDef{rd::Lifetime::Eternal()};
 	rd::SingleThreadScheduler Scheduler{ModuleLifetimeDef.lifetime, "MainScheduler"};
 	TUniquePtr<rd::LifetimeDefinition> WireLifetimeDef;
@@ -54,4 +59,6 @@ private:
 	rd::RdProperty<bool> RdIsModelAlive;
 	TUniquePtr<JetBrains::EditorPlugin::RdEditorModel> EditorModel;
 	FRWLock ModelLock;
+	IConsoleObject* DecodeProtocolTraceCommand = nullptr;
+	IConsoleObject* RdMetricsCommand = nullptr;
 };
@@ -9,16 +9,28 @@
 namespace rd {
 
     FString Polymorphic<FString, void>::read(SerializationCtx& ctx, Buffer& buffer) {
-        UCS2CHAR * str = buffer.read_char16_string();
-        FString tmp{str};
-        delete str;
-        return tmp;
+        static_assert(sizeof(TCHAR) == sizeof(uint16_t), "FString is expected to be UTF-16");
+        FString Result;
+        buffer.read_char16_string([&Result](size_t Len) -> uint16_t* {
+            if (Len == 0) {
+                return nullptr;
+            }
+            TArray<TCHAR>& Chars = Result.GetCharArray();
+            Chars.SetNumUninitialized(static_cast<int32>(Len) + 1);
+            Chars[Len] = TEXT('\0');
+            return reinterpret_cast<uint16_t*>(Chars.GetData());
+        });
+        return Result;
     }
 
     void Polymorphic<FString, void>::write(SerializationCtx& ctx, Buffer& buffer, FString const& value) {
         buffer.write_char16_string(reinterpret_cast<const uint16_t*>(GetData(value)), value.Len());
     }
 
+    size_t Polymorphic<FString, void>::serialized_size(SerializationCtx& ctx, FString const& value) {
+        return sizeof(int32_t) + sizeof(uint16_t) * value.Len();
+    }
+
 
     size_t hash<FString>::operator()(const FString& value) const noexcept {
         return GetTypeHash(value);
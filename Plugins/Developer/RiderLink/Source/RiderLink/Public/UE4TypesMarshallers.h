@@ -31,6 +31,8 @@ namespace rd {
         static FString read(SerializationCtx& ctx, Buffer& buffer);
 
         static void write(SerializationCtx& ctx, Buffer& buffer, FString const& value);
+
+        static size_t serialized_size(SerializationCtx& ctx, FString const& value);
     };
 
     template <>
@@ -23,6 +23,7 @@ public class RiderLink : ModuleRules
 		};
 		
 		PrivateDefinitions.Add("ENABLE_LOG_FILE=0");
+		PrivateDefinitions.Add("ENABLE_PROTOCOL_TRACE=0");
 
 		foreach(var Item in Paths)
 		{